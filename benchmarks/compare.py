@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+# Benchmark Comparison
+#
+# usage: benchmarks/compare.py <baseline.json> <current.json> [--tolerance 0.10]
+#
+# Compares the reports written by benchmarks/run and exits with status 1 if any metric is
+# worse than the baseline by more than the tolerance.
+
+import argparse
+import json
+import sys
+
+# metric name and whether a larger value is better
+METRICS = [
+    ('events_per_s',    True),
+    ('startup_s',       False),
+    ('merge_s',         False),
+    ('peak_rss_kb',     False),
+    ('bytes_per_event', False),
+    ('ns_per_step',     False),
+]
+
+
+def load(path):
+    with open(path) as f:
+        return json.load(f)['scenarios']
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare benchmark results against a baseline.')
+    parser.add_argument('baseline')
+    parser.add_argument('current')
+    parser.add_argument('--tolerance', type=float, default=0.10,
+                        help='allowed relative change before a metric is flagged (default: 0.10)')
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = 0
+    print('{:<20} {:<16} {:>14} {:>14} {:>9}'.format('scenario', 'metric', 'baseline', 'current', 'change'))
+    for scenario in sorted(baseline):
+        if scenario not in current:
+            print('{:<20} missing from current results'.format(scenario))
+            regressions += 1
+            continue
+        for metric, larger_is_better in METRICS:
+            old = baseline[scenario].get(metric)
+            new = current[scenario].get(metric)
+            if old is None or new is None:
+                continue
+            change = (new - old) / old if old else 0.0
+            worse = -change if larger_is_better else change
+            flag = ''
+            if worse > args.tolerance:
+                flag = '  REGRESSION'
+                regressions += 1
+            print('{:<20} {:<16} {:>14.4g} {:>14.4g} {:>+8.1f}%{}'.format(
+                scenario, metric, old, new, 100 * change, flag))
+
+    if regressions:
+        print('\n{} regression(s) beyond {:.0f}%'.format(regressions, 100 * args.tolerance))
+        return 1
+    print('\nNo regressions beyond {:.0f}%'.format(100 * args.tolerance))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,34 @@
+cmake_minimum_required(VERSION 3.5 FATAL_ERROR)
+
+find_path(HEPMC3_INCLUDE_DIR HepMC3/GenEvent.h
+    HINTS
+        $ENV{HEPMC3LOCATION}/include
+        ${HEPMC3LOCATION}/include
+        $ENV{HEPMC3}/include
+        ${HEPMC3}/include
+)
+
+set(HEPMC3_LIBRARY_HINTS
+    HINTS
+        $ENV{HEPMC3LOCATION}/lib
+        ${HEPMC3LOCATION}/lib
+        $ENV{HEPMC3LOCATION}/lib64
+        ${HEPMC3LOCATION}/lib64
+        $ENV{HEPMC3}/lib
+        ${HEPMC3}/lib
+        $ENV{HEPMC3}/lib64
+        ${HEPMC3}/lib64
+)
+
+find_library(HEPMC3_LIBRARY NAMES HepMC3 ${HEPMC3_LIBRARY_HINTS})
+find_library(HEPMC3_ROOTIO_LIBRARY NAMES HepMC3rootIO ${HEPMC3_LIBRARY_HINTS})
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(HepMC3 DEFAULT_MSG HEPMC3_LIBRARY HEPMC3_INCLUDE_DIR)
+
+set(HEPMC3_LIBRARIES ${HEPMC3_LIBRARY})
+if(HEPMC3_ROOTIO_LIBRARY)
+    list(APPEND HEPMC3_LIBRARIES ${HEPMC3_ROOTIO_LIBRARY})
+endif()
+
+mark_as_advanced(HEPMC3_FOUND HEPMC3_LIBRARY HEPMC3_ROOTIO_LIBRARY HEPMC3_INCLUDE_DIR)
@@ -24,6 +24,11 @@
 #include <G4UserEventAction.hh>
 #include <G4UserRunAction.hh>
 #include <G4VUserPrimaryGeneratorAction.hh>
+#include <G4UserStackingAction.hh>
+#include <G4UserSteppingAction.hh>
+#include <G4UserWorkerInitialization.hh>
+#include <G4EmCalculator.hh>
+#include <G4Region.hh>
 #include <G4Event.hh>
 #include <G4Run.hh>
 
@@ -45,10 +50,19 @@ public:
 //__Event Action Manager________________________________________________________________________
 class EventAction : public G4UserEventAction {
 public:
-  EventAction(const size_t print_modulo);
+  EventAction();
   void BeginOfEventAction(const G4Event* event);
+  void EndOfEventAction(const G4Event* event);
   static const G4Event* GetEvent();
   static size_t EventID();
+  static double BusyTime();
+  static size_t EventsProcessed();
+  static void ResetBusyTime();
+  static void SetProgress(const size_t threads,
+                          const double interval,
+                          const std::string& json_path="");
+  static void StartProgress(const size_t events);
+  static void StopProgress();
 };
 //----------------------------------------------------------------------------------------------
 
@@ -58,6 +72,16 @@ public:
   RunAction(const std::string& data_dir="");
   void BeginOfRunAction(const G4Run* run);
   void EndOfRunAction(const G4Run*);
+  static void WaitForFinalization();
+
+  struct Summary {
+    std::size_t runs, events;
+    double run_time, merge_time;
+    std::size_t output_bytes;
+    std::size_t steps;
+    double step_time;
+  };
+  static Summary GetSummary();
   static const G4Run* GetRun();
   static size_t RunID();
   static size_t EventCount();
@@ -81,6 +105,73 @@ private:
 };
 //----------------------------------------------------------------------------------------------
 
+//__Stacking Action Manager_____________________________________________________________________
+class StackingAction : public G4UserStackingAction, public G4UImessenger {
+public:
+  StackingAction();
+  G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track);
+  void PrepareNewEvent();
+  void SetNewValue(G4UIcommand* command, G4String value);
+
+  static const std::string MessengerDirectory;
+
+  static void SetThreshold(const std::string& particle, double energy);
+  static void MergeKillCounts();
+  static void PrintKillCounts(std::ostream& os=std::cout);
+
+private:
+  G4EmCalculator _calculator;
+  const G4Region* _earth;
+
+  Command::BoolArg*   _enable;
+  Command::BoolArg*   _range;
+  Command::StringArg* _threshold;
+  Command::NoArg*     _clear;
+  Command::StringArg* _neutron;
+  Command::StringArg* _gamma;
+  Command::NoArg*     _print;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Stepping Profiler___________________________________________________________________________
+class SteppingAction : public G4UserSteppingAction, public G4UImessenger {
+public:
+  SteppingAction();
+  void UserSteppingAction(const G4Step* step);
+  void SetNewValue(G4UIcommand* command, G4String value);
+
+  static const std::string MessengerDirectory;
+
+  struct ProfileEntry {
+    std::string volume, particle;
+    std::size_t steps;
+    double length, deposit, time;
+  };
+  using Profile = std::vector<ProfileEntry>;
+
+  static bool ProfileEnabled();
+  static void PrepareProfile(std::size_t threads);
+  static void PublishProfile();
+  static Profile MergeProfile();
+  static void PrintProfile(const Profile& profile,
+                           std::ostream& os=std::cout);
+
+private:
+  Command::BoolArg*    _enable;
+  Command::BoolArg*    _timing;
+  Command::IntegerArg* _rows;
+  Command::BoolArg*    _memory;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Worker Thread Initializer___________________________________________________________________
+class WorkerInitialization : public G4UserWorkerInitialization {
+public:
+  WorkerInitialization(const std::string& pin_mode="core");
+  void WorkerInitialize() const;
+};
+//----------------------------------------------------------------------------------------------
+
 } } /* namespace MATHUSLA::MU */
 
 #endif /* MU__ACTION_HH */
@@ -217,21 +217,7 @@ static const DataKeyList DefaultDataKeyList{
   "GEN_E", "GEN_PX", "GEN_PY", "GEN_PZ",
   "GEN_WEIGHT",
 
-  "COSMIC_EVENT_ID",
-
-  "COSMIC_CORE_X",
-  "COSMIC_CORE_Y",
-
-  "COSMIC_GEN_PRIMARY_ENERGY",
-  "COSMIC_GEN_THETA",
-  "COSMIC_GEN_PHI",
-  "COSMIC_GEN_FIRST_HEIGHT",
-  "COSMIC_GEN_ELECTRON_COUNT",
-  "COSMIC_GEN_MUON_COUNT",
-  "COSMIC_GEN_HADRON_COUNT",
-  "COSMIC_GEN_PRIMARY_ID",
-
-  "EXTRA_11", "EXTRA_12", "EXTRA_13", "EXTRA_14", "EXTRA_15"
+  "COSMIC_CORE_X", "COSMIC_CORE_Y"
 };
 static const DataKeyTypeList DefaultDataKeyTypeList{
   DataKeyType::Single,
@@ -266,20 +252,6 @@ static const DataKeyTypeList DefaultDataKeyTypeList{
   DataKeyType::Vector,
   DataKeyType::Vector,
 
-  DataKeyType::Vector,
-  DataKeyType::Vector,
-  DataKeyType::Vector,
-  DataKeyType::Vector,
-  DataKeyType::Vector,
-  DataKeyType::Vector,
-  DataKeyType::Vector,
-  DataKeyType::Vector,
-  DataKeyType::Vector,
-  DataKeyType::Vector,
-  DataKeyType::Vector,
-  DataKeyType::Vector,
-  DataKeyType::Vector,
-  DataKeyType::Vector,
   DataKeyType::Vector,
   DataKeyType::Vector
 };
@@ -291,6 +263,14 @@ bool CreateNTuple(const std::string& name,
                   const DataKeyTypeList& types);
 //----------------------------------------------------------------------------------------------
 
+//__Persistent NTuple Initializer_______________________________________________________________
+// builds the analysis manager and ntuple once per thread and keeps them for later runs, so
+// only the output file changes between runs, rebuilding only if the schema is different
+bool Book(const std::string& name,
+          const DataKeyList& columns,
+          const DataKeyTypeList& types);
+//----------------------------------------------------------------------------------------------
+
 //__Add Data to NTuple__________________________________________________________________________
 bool FillNTuple(const std::string& name,
                 const DataKeyTypeList& types,
@@ -298,6 +278,10 @@ bool FillNTuple(const std::string& name,
                 const DataEntryList& vector_values);
 //----------------------------------------------------------------------------------------------
 
+//__Bytes Reserved by NTuple Columns on this Thread_____________________________________________
+std::size_t DataCapacity();
+//----------------------------------------------------------------------------------------------
+
 } /* namespace ROOT */ /////////////////////////////////////////////////////////////////////////
 
 } /* namespace Analysis */ /////////////////////////////////////////////////////////////////////
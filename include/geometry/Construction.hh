@@ -19,6 +19,8 @@
 #define MU__GEOMETRY_CONSTRUCTION_HH
 #pragma once
 
+#include <vector>
+
 #include <G4VSensitiveDetector.hh>
 #include <G4VUserDetectorConstruction.hh>
 #include <G4LogicalVolume.hh>
@@ -68,7 +70,8 @@ class Builder : public G4VUserDetectorConstruction, public G4UImessenger {
 public:
   Builder(const std::string& detector,
           const std::string& export_dir,
-          const bool save_option);
+          const bool save_option,
+          const std::string& geometry_cache="");
   G4VPhysicalVolume* Construct();
   void ConstructSDandField();
 
@@ -78,17 +81,38 @@ public:
 
   static void SetDetector(const std::string& detector);
   static void SetSaveOption(const bool option);
+  static void SetRegionCut(const std::string& region, double cut);
+  static void SetRegionStep(const std::string& region, double step);
+  static void UpdateRegions();
+  static void SetEarthMode(const std::string& mode);
+  static void CheckEarth(const std::size_t points);
 
   static const std::string& GetDetectorName();
   static bool IsDetectorDataPerEvent();
   static const std::string& GetDetectorDataName();
   static const Analysis::ROOT::DataKeyList& GetDetectorDataKeys();
   static const Analysis::ROOT::DataKeyTypeList& GetDetectorDataKeyTypes();
+  static const G4ThreeVector& GetDetectorEnvelopeMin();
+  static const G4ThreeVector& GetDetectorEnvelopeMax();
 
 private:
   Command::NoArg*     _list;
   Command::NoArg*     _current;
   Command::StringArg* _select;
+  Command::NoArg*     _region_list;
+  std::vector<Command::DoubleUnitArg*> _region_cut;
+  std::vector<Command::DoubleUnitArg*> _region_step;
+  Command::StringArg*  _earth_mode;
+  Command::IntegerArg* _earth_check;
+  Command::BoolArg*       _trigger_enable;
+  Command::StringArg*     _trigger_layer;
+  Command::StringArg*     _trigger_mask;
+  Command::NoArg*         _trigger_clear;
+  Command::IntegerArg*    _trigger_require;
+  Command::DoubleUnitArg* _trigger_window;
+  Command::DoubleUnitArg* _trigger_threshold;
+  Command::NoArg*         _trigger_print;
+  Command::StringArg*     _truth;
 };
 //----------------------------------------------------------------------------------------------
 
@@ -173,13 +197,29 @@ G4LogicalVolume* OpenBoxVolume(const std::string& name,
 G4VPhysicalVolume* PlaceVolume(const std::string& name,
                                G4LogicalVolume* current,
                                G4LogicalVolume* parent,
-                               const G4Transform3D& transform=G4Transform3D());
+                               const G4Transform3D& transform=G4Transform3D(),
+                               const int copy=0);
 //----------------------------------------------------------------------------------------------
 
 //__Physical Volume Placer______________________________________________________________________
 G4VPhysicalVolume* PlaceVolume(G4LogicalVolume* current,
                                G4LogicalVolume* parent,
-                               const G4Transform3D& transform=G4Transform3D());
+                               const G4Transform3D& transform=G4Transform3D(),
+                               const int copy=0);
+//----------------------------------------------------------------------------------------------
+
+//__Parameterised Volume Placer_________________________________________________________________
+G4VPhysicalVolume* PlaceParameterised(G4LogicalVolume* current,
+                                      G4LogicalVolume* parent,
+                                      const std::vector<G4Transform3D>& transforms);
+//----------------------------------------------------------------------------------------------
+
+//__Replica Volume Placer_______________________________________________________________________
+G4VPhysicalVolume* PlaceReplica(G4LogicalVolume* current,
+                                G4LogicalVolume* parent,
+                                const EAxis axis,
+                                const int count,
+                                const double width);
 //----------------------------------------------------------------------------------------------
 
 //__Physical Volume Placer______________________________________________________________________
@@ -25,6 +25,8 @@
 #include <G4Transform3D.hh>
 #include <G4SystemOfUnits.hh>
 
+#include <vector>
+
 namespace MATHUSLA { namespace MU {
 
 namespace Earth { //////////////////////////////////////////////////////////////////////////////
@@ -49,6 +51,8 @@ long double LayerWidthX();
 long double LayerWidthX(long double value);
 long double LayerWidthY();
 long double LayerWidthY(long double value);
+long double BufferZoneShiftX();
+long double BufferZoneShiftX(long double value);
 long double BufferZoneLength();
 long double BufferZoneLength(long double value);
 long double BufferZoneHigherWidth();
@@ -59,6 +63,10 @@ long double BufferZoneHigherDepth();
 long double BufferZoneHigherDepth(long double value);
 long double BufferZoneLowerDepth();
 long double BufferZoneLowerDepth(long double value);
+long double SX1SlabWidth();
+long double SX1SlabWidth(long double value);
+long double SX1SlabDepth();
+long double SX1SlabDepth(long double value);
 long double SandstoneDepth();
 long double SandstoneDepth(long double value);
 long double MarlDepth();
@@ -69,6 +77,11 @@ long double TotalShift();
 long double TotalDepth();
 //----------------------------------------------------------------------------------------------
 
+//__Earth Construction Mode_____________________________________________________________________
+bool Decomposed();
+bool Decomposed(bool value);
+//----------------------------------------------------------------------------------------------
+
 //__Earth Logical Volumes_______________________________________________________________________
 G4LogicalVolume* Volume();
 G4LogicalVolume* SX1SlabVolume();
@@ -85,6 +98,14 @@ const G4Translate3D MarlTransform();
 const G4Translate3D MixTransform();
 //----------------------------------------------------------------------------------------------
 
+//__Earth Layers Decomposed into Boxes__________________________________________________________
+struct Layer {
+  G4LogicalVolume* volume;
+  long double top, bottom;
+};
+std::vector<Layer> PlaceDecomposedLayers(G4LogicalVolume* earth);
+//----------------------------------------------------------------------------------------------
+
 //__Construct Earth_____________________________________________________________________________
 G4VPhysicalVolume* Construct(G4LogicalVolume* world);
 //----------------------------------------------------------------------------------------------
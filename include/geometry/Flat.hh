@@ -71,16 +71,17 @@ public:
         const size_t count,
         const Scintillator* scintillator);
 
-  const std::string&      GetName()              const { return _name;          }
-  G4LogicalVolume*        GetVolume()            const { return _volume;        }
-  G4VPhysicalVolume*      GetPlacement()         const { return _placement;     }
-  size_t                  GetScintillatorCount() const { return _count;         }
-  const ScintillatorList& GetScintillators()     const { return _scintillators; }
+  const std::string&  GetName()              const { return _name;         }
+  G4LogicalVolume*    GetVolume()            const { return _volume;       }
+  G4VPhysicalVolume*  GetPlacement()         const { return _placement;    }
+  size_t              GetScintillatorCount() const { return _count;        }
+  const Scintillator* GetScintillator()      const { return _scintillator; }
 
   void Register(G4VSensitiveDetector* detector);
 
   G4VPhysicalVolume* PlaceIn(G4LogicalVolume* parent,
-                             const G4Transform3D& transform=G4Transform3D());
+                             const G4Transform3D& transform=G4Transform3D(),
+                             const int copy=0);
 
   static Layer* Clone(const Layer& other,
                       const std::string& new_name);
@@ -88,7 +89,7 @@ public:
   constexpr static auto ScintillatorSpacing = 0.3*cm;
 
 private:
-  std::vector<Scintillator*> _scintillators;
+  Scintillator* _scintillator;
   G4LogicalVolume* _volume;
   G4VPhysicalVolume* _placement;
   std::string _name;
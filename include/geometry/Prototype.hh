@@ -24,6 +24,7 @@
 #include "G4VSensitiveDetector.hh"
 
 #include "geometry/Construction.hh"
+#include "geometry/PrototypeTable.hh"
 
 namespace MATHUSLA { namespace MU {
 
@@ -57,29 +58,18 @@ public:
 
   void Register(G4VSensitiveDetector* detector);
 
-  struct PMTPoint { double up, right, r; };
+  static Scintillator* Clone(const Scintillator* other);
 
-  static PMTPoint PMTDistance(const G4ThreeVector position,
-                              const Scintillator* sci,
-                              const G4ThreeVector translation,
-                              const G4RotationMatrix rotation);
+  using Info = Table::ScintillatorInfo;
 
-  static Scintillator* Clone(const Scintillator* other);
+  struct PMTPoint { double up, right, r; };
 
-  struct Info {
-    std::string name;
-    double x;
-    double y;
-    double z;
-    double z_rotation_angle;
-    double long_base;
-    double short_base;
-    double trapezoid_height;
-  };
+  static PMTPoint PMTDistance(const G4ThreeVector& local_position,
+                              const Info& info);
 
-  constexpr static auto Count = 59u;
+  static G4Transform3D Transform(const Info& info);
 
-  const static Info InfoArray[Count];
+  constexpr static auto Count = Table::ScintillatorCount;
 
   constexpr static auto Depth = 12.7 * mm;
 
@@ -113,15 +103,6 @@ using ScintillatorList = std::vector<Scintillator*>;
 
 class RPC {
 public:
-  struct Pad {
-    Pad(int input_id);
-    G4LogicalVolume* lvolume;
-    G4VPhysicalVolume* pvolume;
-    std::vector<G4LogicalVolume*> lvolume_strips;
-    std::vector<G4VPhysicalVolume*> pvolume_strips;
-    int id;
-  };
-
   struct Material {
     static G4Material* Gas;
     static G4Material* PET;
@@ -132,27 +113,21 @@ public:
 
   RPC(int input_id);
 
-  int                GetID()        const { return _id;        }
-  const std::string& GetName()      const { return _name;      }
-  G4LogicalVolume*   GetVolume()    const { return _volume;    }
-  G4VPhysicalVolume* GetPlacement() const { return _placement; }
-  std::vector<Pad*>  GetPadList()   const { return _pads;      }
+  int                GetID()          const { return _id;        }
+  const std::string& GetName()        const { return _name;      }
+  G4LogicalVolume*   GetVolume()      const { return _volume;    }
+  G4LogicalVolume*   GetPadVolume()   const { return _pad;       }
+  G4LogicalVolume*   GetStripVolume() const { return _strip;     }
+  G4VPhysicalVolume* GetPlacement()   const { return _placement; }
 
   void Register(G4VSensitiveDetector* detector);
 
   G4VPhysicalVolume* PlaceIn(G4LogicalVolume* parent,
                              const G4Transform3D& transform=G4Transform3D());
 
-  struct Info {
-    double x;
-    double y;
-    double z;
-    double z_rotation_angle;
-  };
-
-  constexpr static auto Count = 12u;
+  using Info = Table::RPCInfo;
 
-  const static Info InfoArray[Count];
+  constexpr static auto Count = Table::RPCCount;
 
   constexpr static auto Height = 2800*mm;
   constexpr static auto Width  = 1248*mm;
@@ -205,7 +180,8 @@ public:
 
 private:
   G4LogicalVolume* _volume;
-  std::vector<Pad*> _pads;
+  G4LogicalVolume* _pad;
+  G4LogicalVolume* _strip;
   int _id;
   std::string _name;
   G4VPhysicalVolume* _placement;
@@ -218,18 +194,9 @@ public:
   UChannel(const std::string &name, const double length);
   G4LogicalVolume *getLogicalVolume() { return m_logical_volume; }
 
-  struct Info {
-    std::string name;
-    double x;
-    double y;
-    double z;
-    double length;
-    double z_rotation_angle;
-  };
-
-  constexpr static auto Count = 12u;
+  using Info = Table::UChannelInfo;
 
-  const static Info InfoArray[Count];
+  constexpr static auto Count = Table::UChannelCount;
 
   constexpr static auto Height = 5.0 * cm;
   constexpr static auto Width = 9.0 * cm;
@@ -254,6 +221,7 @@ public:
 
   static int EncodeDetector(const std::string& name);
   static const std::string DecodeDetector(int id);
+  static int StripID(int rpc, int pad, int strip);
 
   static const bool DataPerEvent = true;
   static const std::string& DataName;
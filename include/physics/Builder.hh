@@ -0,0 +1,67 @@
+/*
+ * include/physics/Builder.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MU__PHYSICS_BUILDER_HH
+#define MU__PHYSICS_BUILDER_HH
+#pragma once
+
+#include <map>
+
+#include <G4VModularPhysicsList.hh>
+
+#include "analysis.hh"
+#include "ui.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace Physics { ////////////////////////////////////////////////////////////////////////////
+
+//__Physics List Builder Class__________________________________________________________________
+class Builder : public G4UImessenger {
+public:
+  Builder(const std::string& list,
+          const std::string& cut_profile="default");
+
+  void SetNewValue(G4UIcommand* command, G4String value);
+
+  static const std::string MessengerDirectory;
+  static const std::string SimSettingPrefix;
+
+  static G4VModularPhysicsList* MakeList(const std::string& list);
+  static void SetList(const std::string& list);
+  static void SetCutProfile(const std::string& profile);
+  static void SetCutLength(double length);
+
+  static const std::string& GetListName();
+  static const std::string& GetCutProfile();
+  static const std::map<std::string, double>& GetParticleCuts();
+  static const Analysis::SimSettingList GetSpecification();
+
+private:
+  Command::NoArg*         _list;
+  Command::NoArg*         _current;
+  Command::StringArg*     _profile;
+  Command::DoubleUnitArg* _length;
+};
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Physics */ //////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+#endif /* MU__PHYSICS_BUILDER_HH */
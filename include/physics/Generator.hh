@@ -96,6 +96,9 @@ public:
   static const std::string MessengerDirectory;
   static const std::string SimSettingPrefix;
 
+  static void SetSeed(const long seed);
+  static long GetSeed();
+
 protected:
   Generator(const std::string& name,
             const std::string& description);
@@ -138,12 +141,19 @@ public:
 
   const Particle& min() const { return _min; }
   const Particle& max() const { return _max; }
+  std::size_t multiplicity() const { return _multiplicity; }
+  std::size_t batch_size() const { return _batch_size; }
 
 protected:
   virtual void GenerateCommands();
+  void FillSampleBuffer(std::size_t count);
+  void ResetSampleBuffer();
 
   Particle _min, _max;
   bool _using_range_ke;
+  std::size_t _multiplicity, _batch_size, _sample_index;
+  std::vector<double> _eta_samples, _phi_samples, _energy_samples;
+  ParticleVector _last_event;
   Command::DoubleUnitArg* _ui_pT_min;
   Command::DoubleUnitArg* _ui_pT_max;
   Command::DoubleArg*     _ui_eta_min;
@@ -152,6 +162,8 @@ protected:
   Command::DoubleUnitArg* _ui_phi_max;
   Command::DoubleUnitArg* _ui_ke_min;
   Command::DoubleUnitArg* _ui_ke_max;
+  Command::IntegerArg*    _ui_multiplicity;
+  Command::IntegerArg*    _ui_batch_size;
 };
 //----------------------------------------------------------------------------------------------
 
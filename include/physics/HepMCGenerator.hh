@@ -20,9 +20,7 @@
 #define MU__PHYSICS_HEPMCGENERATOR_HH
 #pragma once
 
-// #include <HepMC/HepMC.h>
-// #include <HepMC/ReaderAscii.h>
-// #include <HepMC/ReaderRoot.h>
+#include <memory>
 
 #include "physics/Generator.hh"
 
@@ -30,31 +28,37 @@ namespace MATHUSLA { namespace MU {
 
 namespace Physics { ////////////////////////////////////////////////////////////////////////////
 
-/*
-
+//__HepMC3 File Reader Generator________________________________________________________________
 class HepMCGenerator : public Generator {
 public:
-  HepMCGenerator(const PropagationList& propagation,
-                 bool unique_events=true);
+  HepMCGenerator(const PropagationList& propagation={});
+
+  virtual ~HepMCGenerator() = default;
 
-  const PropagationList GetPropagationList() const { return _propagation_list; };
-  bool UsingUniqueEvents() const { return _unique; }
-  void SetNewValue(G4UIcommand* command, G4String value);
   void GeneratePrimaryVertex(G4Event* event);
+  ParticleVector GetLastEvent() const;
+  void SetNewValue(G4UIcommand* command, G4String value);
+  std::ostream& Print(std::ostream& os=std::cout) const;
 
   virtual const Analysis::SimSettingList GetSpecification() const;
 
-protected:
-  // TODO: union { HepMC::ReaderAscii* ascii; HepMC::ReaderRoot* root; } _reader;
-  // HepMC::ReaderAscii* _reader;
-  bool _using_root_reader;
+  const PropagationList& GetPropagationList() const { return _propagation_list; };
+
+  struct Stream;
+
+private:
+  std::shared_ptr<Stream> _stream;
   PropagationList _propagation_list;
-  // HepMC::GenEvent _current_event;
-  bool _unique;
-  Command::StringArg* _read_file;
+  ParticleVector _last_event;
+  std::string _path;
+  std::size_t _queue_size;
+  bool _stream_ready;
+  Command::StringArg*  _read_file;
+  Command::StringArg*  _add_cut;
+  Command::NoArg*      _clear_cuts;
+  Command::IntegerArg* _ui_queue_size;
 };
-
-*/
+//----------------------------------------------------------------------------------------------
 
 } /* namespace Physics */ //////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,74 @@
+/*
+ * include/physics/MuonTransportModel.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MU__PHYSICS_MUONTRANSPORTMODEL_HH
+#define MU__PHYSICS_MUONTRANSPORTMODEL_HH
+#pragma once
+
+#include <G4VFastSimulationModel.hh>
+#include <G4EmCalculator.hh>
+#include <G4Navigator.hh>
+
+#include "ui.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace Physics { ////////////////////////////////////////////////////////////////////////////
+
+//__Fast Muon Transport Model___________________________________________________________________
+// Moves muons through a region in straight sub-steps, integrating the total stopping power of
+// each material and sampling Highland multiple-scattering deflections, then hands them back to
+// full tracking at the region boundary.
+class MuonTransportModel : public G4VFastSimulationModel, public G4UImessenger {
+public:
+  MuonTransportModel(G4Region* region);
+  ~MuonTransportModel();
+
+  G4bool IsApplicable(const G4ParticleDefinition& particle);
+  G4bool ModelTrigger(const G4FastTrack& fast_track);
+  void DoIt(const G4FastTrack& fast_track, G4FastStep& fast_step);
+
+  void SetNewValue(G4UIcommand* command, G4String value);
+
+  static const std::string MessengerDirectory;
+
+private:
+  double _lose_energy(double energy,
+                      double length,
+                      const G4ParticleDefinition* particle,
+                      const G4Material* material);
+
+  bool _enabled;
+  double _max_step;
+  double _min_energy;
+  double _straggling;
+  G4EmCalculator _calculator;
+  G4Navigator* _navigator;
+
+  Command::BoolArg*       _enable;
+  Command::DoubleUnitArg* _ui_max_step;
+  Command::DoubleUnitArg* _ui_min_energy;
+  Command::DoubleArg*     _ui_straggling;
+};
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Physics */ //////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+#endif /* MU__PHYSICS_MUONTRANSPORTMODEL_HH */
@@ -60,7 +60,6 @@ private:
   static G4ThreadLocal bool _settings_on;
   PropagationList _propagation_list;
   ParticleVector _last_event;
-  std::uint_fast64_t _counter;
   std::string _path;
   std::string _process_string;
   Command::StringArg* _add_cut;
@@ -0,0 +1,77 @@
+/*
+ * include/physics/SurfaceMuonGenerator.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MU__PHYSICS_SURFACEMUONGENERATOR_HH
+#define MU__PHYSICS_SURFACEMUONGENERATOR_HH
+#pragma once
+
+#include "physics/Generator.hh"
+#include "physics/SurvivalTable.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace Physics { ////////////////////////////////////////////////////////////////////////////
+
+//__Surface Muon Generator______________________________________________________________________
+// Samples sea-level cosmic muons from the Gaisser parameterization, transfers them through the
+// rock with a precomputed SurvivalTable and emits the survivors below the rock.
+class SurfaceMuonGenerator : public Generator {
+public:
+  SurfaceMuonGenerator(const std::string& name,
+                       const std::string& description,
+                       const Particle& vertex);
+
+  virtual ~SurfaceMuonGenerator() = default;
+
+  void GeneratePrimaryVertex(G4Event* event);
+  ParticleVector GetLastEvent() const;
+  void SetNewValue(G4UIcommand* command, G4String value);
+  std::ostream& Print(std::ostream& os=std::cout) const;
+  virtual const Analysis::SimSettingList GetSpecification() const;
+
+  const SurvivalTable& table() const { return _table; }
+
+  static void ResetCounters();
+
+protected:
+  virtual void GenerateCommands();
+
+private:
+  double _depth_or_default() const;
+  double _ke_min_or_default() const;
+  double _ke_max_or_default() const;
+  double _cos_zenith_max_or_default() const;
+
+  SurvivalTable _table;
+  std::string _path;
+  double _depth, _ke_min, _ke_max, _zenith_max, _size;
+  ParticleVector _last_event;
+  Command::StringArg*     _ui_table;
+  Command::DoubleUnitArg* _ui_depth;
+  Command::DoubleUnitArg* _ui_ke_min;
+  Command::DoubleUnitArg* _ui_ke_max;
+  Command::DoubleUnitArg* _ui_zenith_max;
+  Command::DoubleUnitArg* _ui_size;
+};
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Physics */ //////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+#endif /* MU__PHYSICS_SURFACEMUONGENERATOR_HH */
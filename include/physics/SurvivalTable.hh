@@ -0,0 +1,190 @@
+/*
+ * include/physics/SurvivalTable.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MU__PHYSICS_SURVIVALTABLE_HH
+#define MU__PHYSICS_SURVIVALTABLE_HH
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace MATHUSLA { namespace MU {
+
+namespace Physics { ////////////////////////////////////////////////////////////////////////////
+
+//__Muon Survival and Energy Transfer Table_____________________________________________________
+// Grid over initial kinetic energy [GeV], cosine of the zenith angle and vertical rock depth [m].
+// Each cell holds the survival probability and evenly spaced quantiles of the final kinetic
+// energy [GeV] of surviving muons. Only depends on the standard library so that ROOT macros in
+// studies/ can write tables with the same code the simulation reads them with.
+class SurvivalTable {
+public:
+  SurvivalTable() = default;
+  SurvivalTable(const std::vector<double>& energies,
+                const std::vector<double>& cos_zeniths,
+                const std::vector<double>& depths,
+                std::size_t quantiles)
+      : _energies(energies), _cos_zeniths(cos_zeniths), _depths(depths), _quantiles(quantiles),
+        _cells(energies.size() * cos_zeniths.size() * depths.size() * (1 + quantiles)) {}
+
+  bool empty() const { return _cells.empty(); }
+  std::size_t quantiles() const { return _quantiles; }
+  const std::vector<double>& energies() const { return _energies; }
+  const std::vector<double>& cos_zeniths() const { return _cos_zeniths; }
+  const std::vector<double>& depths() const { return _depths; }
+
+  float& survival(std::size_t energy,
+                  std::size_t cos_zenith,
+                  std::size_t depth) {
+    return _cells[_offset(energy, cos_zenith, depth)];
+  }
+
+  float* final_energy(std::size_t energy,
+                      std::size_t cos_zenith,
+                      std::size_t depth) {
+    return &_cells[_offset(energy, cos_zenith, depth) + 1];
+  }
+
+  // returns the final kinetic energy of a muon, or zero if it stops in the rock
+  template<class Uniform>
+  double sample(double energy,
+                double cos_zenith,
+                double depth,
+                Uniform&& flat) const {
+    if (empty())
+      return 0;
+    const auto i = _pick(_energies, energy, flat());
+    const auto j = _pick(_cos_zeniths, cos_zenith, flat());
+    const auto k = _pick(_depths, depth, flat());
+    const auto offset = _offset(i, j, k);
+    if (flat() >= _cells[offset])
+      return 0;
+
+    const auto position = flat() * (_quantiles - 1);
+    const auto lower = std::min(static_cast<std::size_t>(position), _quantiles - 2);
+    const auto fraction = position - lower;
+    const auto final_energy = (1 - fraction) * _cells[offset + 1 + lower]
+                            + fraction * _cells[offset + 2 + lower]
+                            + (energy - _energies[i]);
+    return std::max(final_energy, 0.0);
+  }
+
+  bool write(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+      return false;
+    file.write(_magic(), _magic_size);
+    _write_size(file, _energies.size());
+    _write_size(file, _cos_zeniths.size());
+    _write_size(file, _depths.size());
+    _write_size(file, _quantiles);
+    _write_array(file, _energies);
+    _write_array(file, _cos_zeniths);
+    _write_array(file, _depths);
+    _write_array(file, _cells);
+    return static_cast<bool>(file);
+  }
+
+  bool read(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[_magic_size];
+    if (!file || !file.read(magic, _magic_size) || std::memcmp(magic, _magic(), _magic_size))
+      return false;
+    const auto energy_count = _read_size(file);
+    const auto cos_zenith_count = _read_size(file);
+    const auto depth_count = _read_size(file);
+    const auto quantile_count = _read_size(file);
+    if (!file || quantile_count < 2)
+      return false;
+    *this = SurvivalTable(std::vector<double>(energy_count),
+                          std::vector<double>(cos_zenith_count),
+                          std::vector<double>(depth_count),
+                          quantile_count);
+    _read_array(file, _energies);
+    _read_array(file, _cos_zeniths);
+    _read_array(file, _depths);
+    _read_array(file, _cells);
+    if (!file) {
+      *this = SurvivalTable();
+      return false;
+    }
+    return true;
+  }
+
+private:
+  static constexpr std::size_t _magic_size = 8;
+  static const char* _magic() { return "MUSURV01"; }
+
+  std::size_t _offset(std::size_t energy,
+                      std::size_t cos_zenith,
+                      std::size_t depth) const {
+    return ((energy * _cos_zeniths.size() + cos_zenith) * _depths.size() + depth) * (1 + _quantiles);
+  }
+
+  // picks one of the two neighbouring grid points with probability given by linear interpolation
+  static std::size_t _pick(const std::vector<double>& axis,
+                           double value,
+                           double u) {
+    if (axis.size() == 1 || value <= axis.front())
+      return 0;
+    if (value >= axis.back())
+      return axis.size() - 1;
+    const auto upper = static_cast<std::size_t>(std::upper_bound(axis.cbegin(), axis.cend(), value) - axis.cbegin());
+    const auto lower = upper - 1;
+    return u < (value - axis[lower]) / (axis[upper] - axis[lower]) ? upper : lower;
+  }
+
+  static void _write_size(std::ofstream& file,
+                          std::size_t size) {
+    const auto value = static_cast<std::uint32_t>(size);
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  static std::size_t _read_size(std::ifstream& file) {
+    std::uint32_t value{};
+    file.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return value;
+  }
+
+  template<class T>
+  static void _write_array(std::ofstream& file,
+                           const std::vector<T>& values) {
+    file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+  }
+
+  template<class T>
+  static void _read_array(std::ifstream& file,
+                          std::vector<T>& values) {
+    file.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(T));
+  }
+
+  std::vector<double> _energies, _cos_zeniths, _depths;
+  std::size_t _quantiles{};
+  std::vector<float> _cells;
+};
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Physics */ //////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
+
+#endif /* MU__PHYSICS_SURVIVALTABLE_HH */
@@ -20,7 +20,14 @@
 #define MU__TRACKING_HH
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
 #include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <G4Allocator.hh>
 #include <G4THitsCollection.hh>
@@ -34,6 +41,7 @@
 
 #include "analysis.hh"
 #include "physics/Particle.hh"
+#include "physics/Units.hh"
 
 namespace MATHUSLA { namespace MU {
 
@@ -60,9 +68,11 @@ public:
       const std::string& chamber,
       const double deposit,
       const G4LorentzVector position,
-      const G4LorentzVector momentum);
+      const G4LorentzVector momentum,
+      const int detector=-1);
 
   Hit(const G4Step* step, bool post=true);
+  Hit(const G4Step* step, const std::string& chamber, bool post=true);
 
   void Draw();
   void Print(std::ostream& os=std::cout) const;
@@ -73,10 +83,13 @@ public:
   int                    GetTrackID()      const { return _trackID;                     }
   int                    GetParentID()     const { return _parentID;                    }
   const std::string&     GetChamberID()    const { return _chamberID;                   }
+  int                    GetDetectorID()   const { return _detectorID;                  }
   double                 GetDeposit()      const { return _deposit;                     }
   const G4LorentzVector& GetPosition()     const { return _position;                    }
   const G4LorentzVector& GetMomentum()     const { return _momentum;                    }
 
+  void AddDeposit(const double deposit) { _deposit += deposit; }
+
   bool operator==(const Hit& rhs) const {
     return this == &rhs;
   }
@@ -95,6 +108,7 @@ private:
   int _trackID;
   int _parentID;
   std::string _chamberID;
+  int _detectorID;
   double _deposit;
   G4LorentzVector _position;
   G4LorentzVector _momentum;
@@ -138,13 +152,215 @@ const Analysis::ROOT::DataEntryList ConvertToAnalysis(const std::vector<std::vec
 //----------------------------------------------------------------------------------------------
 
 //__Empty Extra Vector__________________________________________________________________________
+// extras change from event to event, settings which are constant over a run belong in the
+// generator specification instead
 inline const std::vector<std::vector<double>>& EmptyExtra() {
-  static const std::vector<std::vector<double>> _empty{
-    {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}};
+  static const std::vector<std::vector<double>> _empty{{}, {}};
   return _empty;
 }
 //----------------------------------------------------------------------------------------------
 
+//__Generator Truth Levels______________________________________________________________________
+// None writes no generator particles, Primaries writes the primaries of the G4Event, Hits writes
+// the primaries which left a hit or whose direct daughters did and Full writes the complete
+// generator record of the event.
+enum class TruthLevel { None, Primaries, Hits, Full };
+const std::string& TruthLevelNames();
+bool SetTruthLevel(const std::string& level);
+void SetTruthLevel(const TruthLevel level);
+TruthLevel GetTruthLevel();
+const std::string GetTruthLevelName();
+//----------------------------------------------------------------------------------------------
+
+//__Convert Generator Truth to Analysis Form at Current Truth Level_____________________________
+const Analysis::ROOT::DataEntryList ConvertTruthToAnalysis(const HitCollection* collection);
+//----------------------------------------------------------------------------------------------
+
+namespace Trigger { ////////////////////////////////////////////////////////////////////////////
+
+//__Online Event Trigger________________________________________________________________________
+// A detector element fires when its summed deposit reaches the threshold, at the time of its
+// earliest hit. An event triggers when the required number of distinct layers fire within the
+// time window. Layers are inclusive ranges of detector IDs, and without any layers every element
+// counts as its own layer. Masks are sets of layers which must all fire together. When masks are
+// set, an event also has to satisfy one of them.
+void Enable(const bool enable);
+bool IsEnabled();
+void AddLayer(const long first,
+              const long last);
+void AddMask(const std::vector<std::size_t>& layers);
+void Clear();
+void SetRequired(const std::size_t layers);
+void SetWindow(const double window);
+void SetThreshold(const double threshold);
+bool Accept(const HitCollection* collection);
+void Print(std::ostream& os=std::cout);
+void PrintCounts(std::ostream& os=std::cout);
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Trigger */ //////////////////////////////////////////////////////////////////////
+
+namespace Memory { /////////////////////////////////////////////////////////////////////////////
+
+//__Hit Memory Instrumentation__________________________________________________________________
+// Each worker records the hits of every event, the bytes they hold and the heap allocations made
+// for them. At the end of the run it publishes these with the pages of its hit allocator and the
+// capacity of its ntuple columns, which only grow during a run. Memory is counted for all
+// hits, including events which are later discarded.
+struct Usage {
+  int thread;
+  std::size_t events;
+  std::size_t hits;
+  std::size_t peak_hits;
+  std::size_t peak_hit_bytes;
+  std::size_t allocations;
+  std::size_t peak_allocations;
+  std::size_t allocator_pages;
+  std::size_t allocator_bytes;
+  std::size_t ntuple_bytes;
+};
+using UsageList = std::vector<Usage>;
+
+void Enable(const bool enable);
+bool IsEnabled();
+void RecordEvent(const HitCollection* collection);
+void Prepare(const std::size_t threads);
+void Publish();
+UsageList Merge();
+Analysis::SimSettingList Specification(const UsageList& usage);
+void Print(const UsageList& usage,
+           std::ostream& os=std::cout);
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Memory */ ///////////////////////////////////////////////////////////////////////
+
+//__Write Event with Generator Truth to NTuple__________________________________________________
+// appends the generator truth at the current truth level and the generator extras to the hit
+// columns and fills one row of the named ntuple
+void WriteEvent(const std::string& name,
+                const Analysis::ROOT::DataKeyTypeList& types,
+                const HitCollection* collection,
+                Analysis::ROOT::DataEntryList& hit_data);
+//----------------------------------------------------------------------------------------------
+
+//__Default Detector Encoder Policy_____________________________________________________________
+// Encoders derive from BasicEncoder and hide the members they change. Encode gives the
+// detector ID of a step and Name its chamber name. ColumnCount extra hit columns named by
+// ColumnKeys are written after WEIGHT and filled from Columns. With Aggregate, the steps of one
+// track in one detector element are merged into a single hit.
+struct BasicEncoder {
+  static constexpr std::size_t ColumnCount = 0UL;
+  static constexpr bool Aggregate = false;
+  static double MinDeposit() { return 0; }
+  static Analysis::ROOT::DataKeyList ColumnKeys() { return {}; }
+  static std::string Name(const int id) { return std::to_string(id); }
+  static std::array<double, 0UL> Columns(const G4Step*, const int) { return {}; }
+};
+//----------------------------------------------------------------------------------------------
+
+//__Detector Hit Pipeline_______________________________________________________________________
+// Owns the per-thread hit collection of a sensitive detector. It encodes and optionally
+// aggregates hits, applies the trigger and writes accepted events.
+template<class Encoder>
+class DetectorPipeline {
+public:
+  static Analysis::ROOT::DataKeyList DataKeys() {
+    auto out = Analysis::ROOT::DefaultDataKeyList;
+    const auto keys = Encoder::ColumnKeys();
+    out.insert(_column_offset(out), keys.cbegin(), keys.cend());
+    return out;
+  }
+
+  static Analysis::ROOT::DataKeyTypeList DataKeyTypes() {
+    auto out = Analysis::ROOT::DefaultDataKeyTypeList;
+    out.insert(out.cbegin() + (_column_offset(Analysis::ROOT::DefaultDataKeyList)
+                               - Analysis::ROOT::DefaultDataKeyList.cbegin()),
+               Encoder::ColumnCount, Analysis::ROOT::DataKeyType::Vector);
+    return out;
+  }
+
+  static void Initialize(G4VSensitiveDetector* detector,
+                         G4HCofThisEvent* event) {
+    _hits = GenerateHitCollection(detector, event);
+    if (!_columns)
+      _columns = new Analysis::ROOT::DataEntryList(Encoder::ColumnCount);
+    for (auto& column : *_columns)
+      column.clear();
+    if (Encoder::Aggregate) {
+      if (!_merged)
+        _merged = new std::unordered_map<std::uint64_t, std::size_t>;
+      _merged->clear();
+    }
+  }
+
+  static G4bool ProcessHit(const G4Step* step) {
+    const auto deposit = step->GetTotalEnergyDeposit();
+    if (!deposit || deposit < Encoder::MinDeposit())
+      return false;
+
+    const auto track = step->GetTrack();
+    const auto id = Encoder::Encode(step);
+
+    if (Encoder::Aggregate) {
+      const auto key = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(id)) << 32)
+                     | static_cast<std::uint32_t>(track->GetTrackID());
+      const auto search = _merged->find(key);
+      if (search != _merged->cend()) {
+        (*_hits)[search->second]->AddDeposit(deposit / Units::Energy);
+        return true;
+      }
+      _merged->emplace(key, _hits->GetSize());
+    }
+
+    const auto post_step = step->GetPostStepPoint();
+    _hits->insert(new Hit(
+      track->GetParticleDefinition(),
+      track->GetTrackID(),
+      track->GetParentID(),
+      Encoder::Name(id),
+      deposit / Units::Energy,
+      G4LorentzVector(post_step->GetGlobalTime()  / Units::Time,   post_step->GetPosition() / Units::Length),
+      G4LorentzVector(post_step->GetTotalEnergy() / Units::Energy, post_step->GetMomentum() / Units::Momentum),
+      id));
+
+    const auto columns = Encoder::Columns(step, id);
+    for (std::size_t i{}; i < Encoder::ColumnCount; ++i)
+      (*_columns)[i].push_back(columns[i]);
+    return true;
+  }
+
+  static void EndOfEvent(const std::string& name,
+                         const Analysis::ROOT::DataKeyTypeList& types,
+                         const bool save_all,
+                         const int verbose) {
+    if (Memory::IsEnabled())
+      Memory::RecordEvent(_hits);
+    if (Trigger::IsEnabled() ? !Trigger::Accept(_hits) : _hits->GetSize() == 0 && !save_all)
+      return;
+
+    auto hit_data = ConvertToAnalysis(_hits);
+    hit_data.insert(hit_data.cend(),
+                    std::make_move_iterator(_columns->begin()),
+                    std::make_move_iterator(_columns->end()));
+    WriteEvent(name, types, _hits, hit_data);
+    if (verbose >= 2)
+      std::cout << *_hits;
+  }
+
+private:
+  static Analysis::ROOT::DataKeyList::const_iterator _column_offset(const Analysis::ROOT::DataKeyList& keys) {
+    return std::find(keys.cbegin(), keys.cend(), "N_GEN");
+  }
+
+  static G4ThreadLocal HitCollection* _hits;
+  static G4ThreadLocal Analysis::ROOT::DataEntryList* _columns;
+  static G4ThreadLocal std::unordered_map<std::uint64_t, std::size_t>* _merged;
+};
+template<class Encoder> G4ThreadLocal HitCollection* DetectorPipeline<Encoder>::_hits = nullptr;
+template<class Encoder> G4ThreadLocal Analysis::ROOT::DataEntryList* DetectorPipeline<Encoder>::_columns = nullptr;
+template<class Encoder> G4ThreadLocal std::unordered_map<std::uint64_t, std::size_t>* DetectorPipeline<Encoder>::_merged = nullptr;
+//----------------------------------------------------------------------------------------------
+
 } /* namespace Tracking */ /////////////////////////////////////////////////////////////////////
 
 } } /* namespace MATHUSLA::MU */
@@ -0,0 +1,195 @@
+/*
+ * include/util/concurrent.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL__CONCURRENT_HH
+#define UTIL__CONCURRENT_HH
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace MATHUSLA {
+
+namespace util { namespace concurrent { ////////////////////////////////////////////////////////
+
+//__Bounded Lock-Free Multi-Producer Multi-Consumer Queue_______________________________________
+// Ring buffer where each cell carries a sequence number. Producers and consumers claim cells
+// with a single compare-and-swap on their own cursor, so no thread ever blocks another.
+// Capacity is rounded up to a power of two.
+template<class T>
+class bounded_queue {
+public:
+  explicit bounded_queue(std::size_t capacity)
+      : _mask(_round_up(capacity) - 1),
+        _cells(new cell[_mask + 1]),
+        _enqueue_position(0),
+        _dequeue_position(0) {
+    for (std::size_t i{}; i <= _mask; ++i)
+      _cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  bounded_queue(const bounded_queue&) = delete;
+  bounded_queue& operator=(const bounded_queue&) = delete;
+
+  bool try_push(T&& value) {
+    cell* target;
+    auto position = _enqueue_position.load(std::memory_order_relaxed);
+    while (true) {
+      target = &_cells[position & _mask];
+      const auto sequence = target->sequence.load(std::memory_order_acquire);
+      const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+      if (difference == 0) {
+        if (_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+          break;
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = _enqueue_position.load(std::memory_order_relaxed);
+      }
+    }
+    target->value = std::move(value);
+    target->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_pop(T& value) {
+    cell* target;
+    auto position = _dequeue_position.load(std::memory_order_relaxed);
+    while (true) {
+      target = &_cells[position & _mask];
+      const auto sequence = target->sequence.load(std::memory_order_acquire);
+      const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+      if (difference == 0) {
+        if (_dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+          break;
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = _dequeue_position.load(std::memory_order_relaxed);
+      }
+    }
+    value = std::move(target->value);
+    target->sequence.store(position + _mask + 1, std::memory_order_release);
+    return true;
+  }
+
+  std::size_t capacity() const { return _mask + 1; }
+
+private:
+  struct cell {
+    std::atomic<std::size_t> sequence;
+    T value;
+  };
+
+  static std::size_t _round_up(std::size_t capacity) {
+    std::size_t out = 2;
+    while (out < capacity)
+      out <<= 1;
+    return out;
+  }
+
+  const std::size_t _mask;
+  const std::unique_ptr<cell[]> _cells;
+  alignas(64) std::atomic<std::size_t> _enqueue_position;
+  alignas(64) std::atomic<std::size_t> _dequeue_position;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Single Background Thread Running Tasks in Submission Order__________________________________
+// The thread is started by the first push. wait() blocks until every submitted task has run,
+// and the destructor waits before joining. Exceptions thrown by a task are dropped.
+class serial_executor {
+public:
+  serial_executor() : _pending(0), _stop(false) {}
+
+  ~serial_executor() {
+    wait();
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _wake.notify_all();
+    if (_thread.joinable())
+      _thread.join();
+  }
+
+  serial_executor(const serial_executor&) = delete;
+  serial_executor& operator=(const serial_executor&) = delete;
+
+  void push(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (!_thread.joinable())
+        _thread = std::thread(&serial_executor::_run, this);
+      _tasks.push_back(std::move(task));
+      ++_pending;
+    }
+    _wake.notify_one();
+  }
+
+  void wait() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [&]{ return !_pending; });
+  }
+
+  std::size_t pending() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pending;
+  }
+
+private:
+  void _run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+      _wake.wait(lock, [&]{ return _stop || !_tasks.empty(); });
+      if (_tasks.empty())
+        return;
+      auto task = std::move(_tasks.front());
+      _tasks.pop_front();
+      lock.unlock();
+      try {
+        task();
+      } catch (...) {}
+      lock.lock();
+      --_pending;
+      _done.notify_all();
+    }
+  }
+
+  std::deque<std::function<void()>> _tasks;
+  std::size_t _pending;
+  bool _stop;
+  std::mutex _mutex;
+  std::condition_variable _wake;
+  std::condition_variable _done;
+  std::thread _thread;
+};
+//----------------------------------------------------------------------------------------------
+
+} } /* namespace util::concurrent */ ///////////////////////////////////////////////////////////
+
+} /* namespace MATHUSLA */
+
+#endif /* UTIL__CONCURRENT_HH */
@@ -48,6 +48,13 @@ inline bool path_exists(const std::string& path) {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Size of File in Bytes (0 if Missing)________________________________________________________
+inline std::size_t file_size(const std::string& path) {
+  struct stat info;
+  return stat(path.c_str(), &info) ? 0UL : static_cast<std::size_t>(info.st_size);
+}
+//----------------------------------------------------------------------------------------------
+
 //__Remove File_________________________________________________________________________________
 inline bool remove_file(const std::string& path) {
   return !std::remove(path.c_str());
@@ -0,0 +1,100 @@
+/*
+ * include/util/progress.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL__PROGRESS_HH
+#define UTIL__PROGRESS_HH
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MATHUSLA {
+
+namespace util { namespace progress { //////////////////////////////////////////////////////////
+
+//__Background Progress and Throughput Reporter_________________________________________________
+// Producers only bump relaxed atomics in their own cache line. A single reporter thread wakes
+// every interval, reads the counters and writes one line of text or one JSON object.
+class reporter {
+public:
+  reporter(std::size_t slots,
+           double interval,
+           bool json=false,
+           std::ostream& os=std::cout);
+  ~reporter();
+
+  reporter(const reporter&) = delete;
+  reporter& operator=(const reporter&) = delete;
+
+  void start(std::size_t total);
+  void stop();
+
+  void add(std::size_t slot,
+           std::size_t events,
+           std::size_t hits) {
+    if (slot >= _slot_count)
+      return;
+    _slots[slot].events.fetch_add(events, std::memory_order_relaxed);
+    _slots[slot].hits.fetch_add(hits, std::memory_order_relaxed);
+  }
+
+private:
+  // padded to two cache lines so neighbouring counters never share a line, even when the
+  // array itself is not cache-line aligned
+  struct slot {
+    std::atomic<std::uint_fast64_t> events;
+    std::atomic<std::uint_fast64_t> hits;
+    char padding[128 - 2 * sizeof(std::atomic<std::uint_fast64_t>)];
+  };
+
+  using clock = std::chrono::steady_clock;
+
+  void _run();
+  void _report(bool final);
+
+  const std::size_t _slot_count;
+  const std::unique_ptr<slot[]> _slots;
+  const double _interval;
+  const bool _json;
+  std::ostream& _os;
+
+  std::size_t _total;
+  clock::time_point _start;
+  clock::time_point _last;
+  std::vector<std::uint_fast64_t> _last_events;
+
+  std::thread _thread;
+  std::mutex _mutex;
+  std::condition_variable _wake;
+  bool _running;
+};
+//----------------------------------------------------------------------------------------------
+
+} } /* namespace util::progress */ /////////////////////////////////////////////////////////////
+
+} /* namespace MATHUSLA */
+
+#endif /* UTIL__PROGRESS_HH */
@@ -0,0 +1,420 @@
+/*
+ * include/util/spatial_index.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL__SPATIAL_INDEX_HH
+#define UTIL__SPATIAL_INDEX_HH
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace MATHUSLA {
+
+namespace util { namespace spatial { ///////////////////////////////////////////////////////////
+
+//__Point in Global Coordinates_________________________________________________________________
+using point = std::array<double, 3>;
+//----------------------------------------------------------------------------------------------
+
+//__Sensitive Element as Oriented Prism_________________________________________________________
+// The element occupies |y| <= half_y and |z| <= half_z in its own frame. The half width in x
+// grows linearly from half_x_low at z = -half_z to half_x_high at z = +half_z, which covers both
+// boxes and the trapezoids of the prototype scintillators. axes[i] is the global direction of
+// local axis i.
+struct element {
+  int id;
+  point centre;
+  std::array<point, 3> axes;
+  double half_x_low, half_x_high, half_y, half_z;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Segment Crossing through an Element_________________________________________________________
+// Entry and exit are fractions of the segment, so 0 is its start and 1 its end.
+struct crossing {
+  int id;
+  double entry, exit;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Transform Point into Element Frame__________________________________________________________
+inline point to_local(const element& e,
+                      const point& global) {
+  const point v{{global[0] - e.centre[0], global[1] - e.centre[1], global[2] - e.centre[2]}};
+  point out;
+  for (std::size_t i{}; i < 3; ++i)
+    out[i] = e.axes[i][0] * v[0] + e.axes[i][1] * v[1] + e.axes[i][2] * v[2];
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Bounding Planes of Element__________________________________________________________________
+// Each plane is {nx, ny, nz, d} in the element frame and the inside is n . p <= d.
+inline std::array<std::array<double, 4>, 6> planes(const element& e) {
+  const auto slope = e.half_z > 0 ? 0.5 * (e.half_x_high - e.half_x_low) / e.half_z : 0.0;
+  const auto middle = 0.5 * (e.half_x_high + e.half_x_low);
+  return {{{{ 1.0, 0.0, -slope, middle}},
+           {{-1.0, 0.0, -slope, middle}},
+           {{ 0.0, 1.0,    0.0, e.half_y}},
+           {{ 0.0,-1.0,    0.0, e.half_y}},
+           {{ 0.0, 0.0,    1.0, e.half_z}},
+           {{ 0.0, 0.0,   -1.0, e.half_z}}}};
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Element Contains Point_____________________________________________________________
+inline bool contains(const element& e,
+                     const point& global) {
+  const auto local = to_local(e, global);
+  for (const auto& plane : planes(e))
+    if (plane[0] * local[0] + plane[1] * local[1] + plane[2] * local[2] > plane[3])
+      return false;
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Clip Segment to Element_____________________________________________________________________
+// Returns false if the segment from start to end misses the element.
+inline bool clip(const element& e,
+                 const point& start,
+                 const point& end,
+                 double& entry,
+                 double& exit) {
+  const auto local_start = to_local(e, start);
+  const auto local_end = to_local(e, end);
+  entry = 0.0;
+  exit = 1.0;
+  for (const auto& plane : planes(e)) {
+    double distance = plane[3], rate = 0.0;
+    for (std::size_t i{}; i < 3; ++i) {
+      distance -= plane[i] * local_start[i];
+      rate += plane[i] * (local_end[i] - local_start[i]);
+    }
+    if (rate == 0.0) {
+      if (distance < 0.0)
+        return false;
+    } else if (rate < 0.0) {
+      entry = std::max(entry, distance / rate);
+    } else {
+      exit = std::min(exit, distance / rate);
+    }
+    if (entry > exit)
+      return false;
+  }
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Uniform Grid over Sensitive Elements________________________________________________________
+// Every cell lists the elements whose axis aligned bounds overlap it. The file format is the
+// magic "MUSPIDX", a version, the element and grid headers, the elements and then the cell
+// offsets and contents, all in native byte order.
+class grid {
+public:
+  grid() : _dims{{0, 0, 0}}, _min{{0, 0, 0}}, _cell{{1, 1, 1}} {}
+
+  explicit grid(std::vector<element> elements,
+                const double elements_per_cell=1.0)
+      : _elements(std::move(elements)) {
+    _build(elements_per_cell);
+  }
+
+  const std::vector<element>& elements() const { return _elements; }
+  const std::array<std::uint32_t, 3>& dimensions() const { return _dims; }
+
+  // Detector ID of the element containing the point, or -1 if there is none.
+  int locate(const point& global) const {
+    std::size_t cell;
+    if (!_cell_of(global, cell))
+      return -1;
+    for (auto i = _offsets[cell]; i < _offsets[cell + 1]; ++i) {
+      const auto& e = _elements[_items[i]];
+      if (contains(e, global))
+        return e.id;
+    }
+    return -1;
+  }
+
+  // Elements crossed by the segment from start to end, sorted by entry.
+  std::vector<crossing> cross(const point& start,
+                              const point& end) const {
+    std::vector<crossing> out;
+    if (_elements.empty())
+      return out;
+
+    point direction;
+    double first = 0.0, last = 1.0;
+    for (std::size_t k{}; k < 3; ++k) {
+      direction[k] = end[k] - start[k];
+      const auto upper = _min[k] + _dims[k] * _cell[k];
+      if (direction[k] == 0.0) {
+        if (start[k] < _min[k] || start[k] > upper)
+          return out;
+        continue;
+      }
+      auto near = (_min[k] - start[k]) / direction[k];
+      auto far = (upper - start[k]) / direction[k];
+      if (near > far)
+        std::swap(near, far);
+      first = std::max(first, near);
+      last = std::min(last, far);
+      if (first > last)
+        return out;
+    }
+
+    std::array<long, 3> index, step;
+    std::array<double, 3> next, delta;
+    for (std::size_t k{}; k < 3; ++k) {
+      const auto position = start[k] + first * direction[k];
+      index[k] = std::min(std::max(static_cast<long>(std::floor((position - _min[k]) / _cell[k])), 0L),
+                          static_cast<long>(_dims[k]) - 1);
+      if (direction[k] > 0.0) {
+        step[k] = 1;
+        next[k] = (_min[k] + (index[k] + 1) * _cell[k] - start[k]) / direction[k];
+        delta[k] = _cell[k] / direction[k];
+      } else if (direction[k] < 0.0) {
+        step[k] = -1;
+        next[k] = (_min[k] + index[k] * _cell[k] - start[k]) / direction[k];
+        delta[k] = -_cell[k] / direction[k];
+      } else {
+        step[k] = 0;
+        next[k] = delta[k] = std::numeric_limits<double>::infinity();
+      }
+    }
+
+    std::vector<std::uint32_t> candidates;
+    while (true) {
+      const auto cell = _flatten(index[0], index[1], index[2]);
+      candidates.insert(candidates.end(), _items.begin() + _offsets[cell], _items.begin() + _offsets[cell + 1]);
+      const auto axis = next[0] < next[1] ? (next[0] < next[2] ? 0 : 2) : (next[1] < next[2] ? 1 : 2);
+      if (next[axis] > last)
+        break;
+      index[axis] += step[axis];
+      if (index[axis] < 0 || index[axis] >= static_cast<long>(_dims[axis]))
+        break;
+      next[axis] += delta[axis];
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    for (const auto candidate : candidates) {
+      const auto& e = _elements[candidate];
+      double entry, exit;
+      if (clip(e, start, end, entry, exit))
+        out.push_back({e.id, entry, exit});
+    }
+    std::sort(out.begin(), out.end(),
+      [](const crossing& left, const crossing& right) { return left.entry < right.entry; });
+    return out;
+  }
+
+  bool read(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[8];
+    std::uint32_t version, count, items;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, _magic(), sizeof(magic))
+        || !_read(file, version) || version != _version() || !_read(file, count))
+      return false;
+    for (auto& dim : _dims) _read(file, dim);
+    for (auto& value : _min) _read(file, value);
+    for (auto& value : _cell) _read(file, value);
+
+    _elements.resize(count);
+    for (auto& e : _elements) {
+      std::int32_t id;
+      _read(file, id);
+      e.id = id;
+      for (auto& value : e.centre) _read(file, value);
+      for (auto& axis : e.axes)
+        for (auto& value : axis) _read(file, value);
+      _read(file, e.half_x_low);
+      _read(file, e.half_x_high);
+      _read(file, e.half_y);
+      _read(file, e.half_z);
+    }
+
+    _offsets.resize(static_cast<std::size_t>(_dims[0]) * _dims[1] * _dims[2] + 1);
+    for (auto& offset : _offsets) _read(file, offset);
+    items = _offsets.back();
+    _items.resize(items);
+    for (auto& item : _items) _read(file, item);
+    return static_cast<bool>(file);
+  }
+
+  bool write(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    file.write(_magic(), 8);
+    _write(file, _version());
+    _write(file, static_cast<std::uint32_t>(_elements.size()));
+    for (const auto dim : _dims) _write(file, dim);
+    for (const auto value : _min) _write(file, value);
+    for (const auto value : _cell) _write(file, value);
+    for (const auto& e : _elements) {
+      _write(file, static_cast<std::int32_t>(e.id));
+      for (const auto value : e.centre) _write(file, value);
+      for (const auto& axis : e.axes)
+        for (const auto value : axis) _write(file, value);
+      _write(file, e.half_x_low);
+      _write(file, e.half_x_high);
+      _write(file, e.half_y);
+      _write(file, e.half_z);
+    }
+    for (const auto offset : _offsets) _write(file, offset);
+    for (const auto item : _items) _write(file, item);
+    return static_cast<bool>(file);
+  }
+
+private:
+  static const char* _magic() { return "MUSPIDX"; }
+  static std::uint32_t _version() { return 1; }
+
+  template<class T>
+  static bool _read(std::istream& stream, T& value) {
+    return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+  }
+
+  template<class T>
+  static void _write(std::ostream& stream, const T& value) {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  static std::pair<point, point> _bounds(const element& e) {
+    std::pair<point, point> out;
+    for (std::size_t k{}; k < 3; ++k) {
+      out.first[k] = std::numeric_limits<double>::infinity();
+      out.second[k] = -std::numeric_limits<double>::infinity();
+    }
+    for (const auto z : {-1.0, 1.0}) {
+      const auto half_x = z < 0 ? e.half_x_low : e.half_x_high;
+      for (const auto x : {-1.0, 1.0}) {
+        for (const auto y : {-1.0, 1.0}) {
+          for (std::size_t k{}; k < 3; ++k) {
+            const auto corner = e.centre[k] + x * half_x * e.axes[0][k]
+                                            + y * e.half_y * e.axes[1][k]
+                                            + z * e.half_z * e.axes[2][k];
+            out.first[k] = std::min(out.first[k], corner);
+            out.second[k] = std::max(out.second[k], corner);
+          }
+        }
+      }
+    }
+    return out;
+  }
+
+  std::size_t _flatten(const long x,
+                       const long y,
+                       const long z) const {
+    return (static_cast<std::size_t>(z) * _dims[1] + y) * _dims[0] + x;
+  }
+
+  bool _cell_of(const point& global,
+                std::size_t& cell) const {
+    std::array<long, 3> index;
+    for (std::size_t k{}; k < 3; ++k) {
+      const auto position = std::floor((global[k] - _min[k]) / _cell[k]);
+      if (!(position >= 0.0 && position < _dims[k]))
+        return false;
+      index[k] = static_cast<long>(position);
+    }
+    cell = _flatten(index[0], index[1], index[2]);
+    return true;
+  }
+
+  void _build(const double elements_per_cell) {
+    std::vector<std::pair<point, point>> bounds;
+    bounds.reserve(_elements.size());
+    point upper;
+    for (std::size_t k{}; k < 3; ++k) {
+      _min[k] = std::numeric_limits<double>::infinity();
+      upper[k] = -std::numeric_limits<double>::infinity();
+    }
+    for (const auto& e : _elements) {
+      bounds.push_back(_bounds(e));
+      for (std::size_t k{}; k < 3; ++k) {
+        _min[k] = std::min(_min[k], bounds.back().first[k]);
+        upper[k] = std::max(upper[k], bounds.back().second[k]);
+      }
+    }
+    if (_elements.empty())
+      _min = upper = point{{0, 0, 0}};
+
+    point extent;
+    auto volume = 1.0;
+    for (std::size_t k{}; k < 3; ++k) {
+      const auto padding = 1e-6 * std::max(1.0, upper[k] - _min[k]);
+      _min[k] -= padding;
+      extent[k] = upper[k] + padding - _min[k];
+      volume *= extent[k];
+    }
+    const auto cells = std::max(1.0, _elements.size() / std::max(elements_per_cell, 1e-3));
+    const auto side = std::cbrt(volume / cells);
+    for (std::size_t k{}; k < 3; ++k) {
+      _dims[k] = static_cast<std::uint32_t>(std::min(std::max(std::ceil(extent[k] / side), 1.0), 256.0));
+      _cell[k] = extent[k] / _dims[k];
+    }
+
+    std::vector<std::array<long, 6>> ranges;
+    ranges.reserve(bounds.size());
+    _offsets.assign(static_cast<std::size_t>(_dims[0]) * _dims[1] * _dims[2] + 1, 0);
+    for (const auto& bound : bounds) {
+      std::array<long, 6> range;
+      for (std::size_t k{}; k < 3; ++k) {
+        const auto last = static_cast<long>(_dims[k]) - 1;
+        range[k] = std::min(std::max(static_cast<long>((bound.first[k] - _min[k]) / _cell[k]), 0L), last);
+        range[k + 3] = std::min(std::max(static_cast<long>((bound.second[k] - _min[k]) / _cell[k]), 0L), last);
+      }
+      for (auto z = range[2]; z <= range[5]; ++z)
+        for (auto y = range[1]; y <= range[4]; ++y)
+          for (auto x = range[0]; x <= range[3]; ++x)
+            ++_offsets[_flatten(x, y, z) + 1];
+      ranges.push_back(range);
+    }
+    for (std::size_t i = 1; i < _offsets.size(); ++i)
+      _offsets[i] += _offsets[i - 1];
+
+    _items.resize(_offsets.back());
+    auto fill = _offsets;
+    for (std::size_t i{}; i < ranges.size(); ++i) {
+      const auto& range = ranges[i];
+      for (auto z = range[2]; z <= range[5]; ++z)
+        for (auto y = range[1]; y <= range[4]; ++y)
+          for (auto x = range[0]; x <= range[3]; ++x)
+            _items[fill[_flatten(x, y, z)]++] = static_cast<std::uint32_t>(i);
+    }
+  }
+
+  std::vector<element> _elements;
+  std::array<std::uint32_t, 3> _dims;
+  point _min, _cell;
+  std::vector<std::uint32_t> _offsets, _items;
+};
+//----------------------------------------------------------------------------------------------
+
+} } /* namespace util::spatial */ //////////////////////////////////////////////////////////////
+
+} /* namespace MATHUSLA */
+
+#endif /* UTIL__SPATIAL_INDEX_HH */
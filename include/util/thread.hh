@@ -0,0 +1,68 @@
+/*
+ * include/util/thread.hh
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTIL__THREAD_HH
+#define UTIL__THREAD_HH
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace MATHUSLA {
+
+namespace util { namespace thread { ////////////////////////////////////////////////////////////
+
+//__List of Logical CPU Indices_________________________________________________________________
+using cpu_list = std::vector<int>;
+//----------------------------------------------------------------------------------------------
+
+//__Parse Kernel CPU List (ex: "0-3,8,10-11")___________________________________________________
+cpu_list parse_cpu_list(const std::string& text);
+//----------------------------------------------------------------------------------------------
+
+//__Format CPU List in Kernel Notation__________________________________________________________
+std::string format_cpu_list(const cpu_list& cpus);
+//----------------------------------------------------------------------------------------------
+
+//__CPUs this Process is Allowed to Run On______________________________________________________
+cpu_list allowed_cpus();
+//----------------------------------------------------------------------------------------------
+
+//__CPU Limit from cgroup Quota (0 if Unlimited)________________________________________________
+std::size_t cgroup_cpu_limit();
+//----------------------------------------------------------------------------------------------
+
+//__Usable Number of Cores______________________________________________________________________
+// smaller of the affinity mask size and the cgroup quota, falling back to hardware concurrency
+std::size_t available_cores();
+//----------------------------------------------------------------------------------------------
+
+//__Allowed CPUs Grouped by NUMA Node___________________________________________________________
+std::vector<cpu_list> numa_nodes();
+//----------------------------------------------------------------------------------------------
+
+//__Bind Calling Thread to CPUs_________________________________________________________________
+bool pin_current_thread(const cpu_list& cpus);
+//----------------------------------------------------------------------------------------------
+
+} } /* namespace util::thread */ ///////////////////////////////////////////////////////////////
+
+} /* namespace MATHUSLA */
+
+#endif /* UTIL__THREAD_HH */
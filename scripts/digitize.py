@@ -117,14 +117,35 @@ EXTRA_KEYS = [
 ]
 
 
-ALL_KEYS = KEYS + EXTRA_KEYS
+PMT_KEYS = [
+    "PMT_UP",
+    "PMT_RIGHT",
+    "PMT_R",
+]
+
+
+def get_extra_keys(tree):
+    """Generator and Extra Keys Present in the Tree, Resolving Alternative Names."""
+    out = []
+    for key in EXTRA_KEYS:
+        for subkey in key if isinstance(key, list) else [key]:
+            if hasattr(tree, subkey):
+                out.append(subkey)
+                break
+    return out
 
 
-def get_event_components(row):
+def get_hit_keys(tree):
+    """Hit Keys and Types, including PMT Distances when the Tree has them."""
+    pmt_keys = [key for key in PMT_KEYS if hasattr(tree, key)]
+    return KEYS + pmt_keys, DTYPE + [(key, "float64") for key in pmt_keys]
+
+
+def get_event_components(row, keys=KEYS, dtype=DTYPE):
     """"""
     return (
         np.sort(
-            np.array(list(zip(*row[KEYS])), dtype=DTYPE), order=["Detector", "Time"]
+            np.array(list(zip(*row[keys])), dtype=dtype), order=["Detector", "Time"]
         ),
         row,
     )
@@ -152,38 +173,26 @@ def get_subtimes(subevent, threshold, spacing):
     return subevent
 
 
-def clear_row(tree):
+def clear_row(tree, keys=KEYS, extra_keys=None):
     """"""
-    for key in ALL_KEYS:
-        if isinstance(key, list):
-            for subkey in key:
-                if hasattr(tree, subkey):
-                    key = subkey
-                    break
-            if isinstance(key, list):
-                raise AttributeError('Tree does not contain one of the expected branch names')
+    for key in keys + (get_extra_keys(tree) if extra_keys is None else extra_keys):
         getattr(tree, key).clear()
 
 
-def fill_tree(tree, subevent, fullevent):
+def fill_tree(tree, subevent, fullevent, keys=KEYS, extra_keys=None):
     """"""
+    if extra_keys is None:
+        extra_keys = get_extra_keys(tree)
     tree.N_HITS = len(subevent)
     tree.N_GEN = len(fullevent["GEN_PDG"])
     for entry in subevent:
-        for key in KEYS:
+        for key in keys:
             getattr(tree, key).push_back(entry[key])
-    for key in EXTRA_KEYS:
-        if isinstance(key, list):
-            for subkey in key:
-                if hasattr(tree, subkey):
-                    key = subkey
-                    break
-            if isinstance(key, list):
-                raise AttributeError('Tree does not contain one of the expected branch names')
+    for key in extra_keys:
         for entry in fullevent[key]:
             getattr(tree, key).push_back(entry)
     tree.Fill()
-    clear_row(tree)
+    clear_row(tree, keys, extra_keys)
 
 
 def digitize_tree(
@@ -200,7 +209,10 @@ def digitize_tree(
         thresholds = {"scintillator": 0.65 * u.MeV, "rpc": 0.17 * u.keV}
     output.cd()
     ctree.SetDirectory(output)
-    for (event, fullevent) in map(get_event_components, root2array(path, treename)):
+    keys, dtype = get_hit_keys(ctree)
+    extra_keys = get_extra_keys(ctree)
+    rows = root2array(path, treename)
+    for (event, fullevent) in map(lambda row: get_event_components(row, keys, dtype), rows):
         arrays = []
         for detector in np.unique(event["Detector"]):
             detector_only = event[event["Detector"] == detector]
@@ -209,7 +221,7 @@ def digitize_tree(
             if len(subevent) > 0:
                 arrays.append(subevent)
         concatenated_array = np.concatenate(arrays, axis=0) if len(arrays) > 0 else []
-        fill_tree(ctree, concatenated_array, fullevent)
+        fill_tree(ctree, concatenated_array, fullevent, keys, extra_keys)
     return ctree
 
 
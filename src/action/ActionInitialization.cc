@@ -40,14 +40,22 @@ ActionInitialization::ActionInitialization(const std::string& generator,
 //__Build for Thread Master_____________________________________________________________________
 void ActionInitialization::BuildForMaster() const {
   SetUserAction(new RunAction(_data_dir));
+  // master keeps its own lazily built generators so that generator commands exist on the
+  // master and the run metadata can be read without touching worker-owned generators, the
+  // stacking and profiler messengers are kept for the same reason
+  new GeneratorAction(_generator);
+  new StackingAction;
+  new SteppingAction;
 }
 //----------------------------------------------------------------------------------------------
 
 //__Build for Threads___________________________________________________________________________
 void ActionInitialization::Build() const {
   SetUserAction(new RunAction(_data_dir));
-  SetUserAction(new EventAction(100));
+  SetUserAction(new EventAction);
   SetUserAction(new GeneratorAction(_generator));
+  SetUserAction(new StackingAction);
+  SetUserAction(new SteppingAction);
 }
 //----------------------------------------------------------------------------------------------
 
@@ -17,33 +17,68 @@
 
 #include "action.hh"
 
+#include <chrono>
+#include <fstream>
+#include <memory>
+
 #include <G4MTRunManager.hh>
+#include <G4Threading.hh>
+#include <G4HCofThisEvent.hh>
 #include <tls.hh>
 
+#include "util/progress.hh"
+
 namespace MATHUSLA { namespace MU {
 
 namespace { ////////////////////////////////////////////////////////////////////////////////////
-//__Printing Frequency for Event Count__________________________________________________________
-G4ThreadLocal size_t _print_modulo;
+//__Current Event ID____________________________________________________________________________
 G4ThreadLocal uint_fast64_t _event_id{};
 //----------------------------------------------------------------------------------------------
+
+//__Time Spent Processing Events on this Thread_________________________________________________
+G4ThreadLocal double _event_start{};
+G4ThreadLocal double _busy_time{};
+G4ThreadLocal size_t _events_processed{};
+//----------------------------------------------------------------------------------------------
+
+//__Progress Reporter Shared by All Threads_____________________________________________________
+std::unique_ptr<std::ofstream> _progress_file;
+std::unique_ptr<util::progress::reporter> _progress;
+//----------------------------------------------------------------------------------------------
+
+//__Monotonic Time in Seconds___________________________________________________________________
+double _now() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+//----------------------------------------------------------------------------------------------
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 //__Event Action Constructor____________________________________________________________________
-EventAction::EventAction(const size_t print_modulo) : G4UserEventAction() {
-  _print_modulo = print_modulo;
-}
+EventAction::EventAction() : G4UserEventAction() {}
 //----------------------------------------------------------------------------------------------
 
 //__Event Initialization________________________________________________________________________
 void EventAction::BeginOfEventAction(const G4Event* event) {
+  _event_start = _now();
   _event_id = event->GetEventID();
-  std::cout << "\r  Event [ "
-             + std::to_string(_event_id)
-             + " ] @ ("
-             + std::to_string(event->GetNumberOfPrimaryVertex())
-             + " primaries)"
-             + (!(_event_id % _print_modulo) ? "\n\n" : "");
+}
+//----------------------------------------------------------------------------------------------
+
+//__Event Finalization__________________________________________________________________________
+void EventAction::EndOfEventAction(const G4Event* event) {
+  _busy_time += _now() - _event_start;
+  ++_events_processed;
+  if (!_progress)
+    return;
+  std::size_t hits{};
+  if (const auto collections = event->GetHCofThisEvent()) {
+    for (int i{}; i < collections->GetNumberOfCollections(); ++i) {
+      const auto collection = collections->GetHC(i);
+      if (collection)
+        hits += collection->GetSize();
+    }
+  }
+  _progress->add(G4Threading::G4GetThreadId(), 1, hits);
 }
 //----------------------------------------------------------------------------------------------
 
@@ -59,4 +94,58 @@ size_t EventAction::EventID() {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Get Time Spent Processing Events on this Thread_____________________________________________
+double EventAction::BusyTime() {
+  return _busy_time;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Number of Events Processed on this Thread_______________________________________________
+size_t EventAction::EventsProcessed() {
+  return _events_processed;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Reset Thread Event Timing___________________________________________________________________
+void EventAction::ResetBusyTime() {
+  _busy_time = 0;
+  _events_processed = 0;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Configure Progress Reporter_________________________________________________________________
+void EventAction::SetProgress(const size_t threads,
+                              const double interval,
+                              const std::string& json_path) {
+  _progress.reset();
+  _progress_file.reset();
+  if (!json_path.empty()) {
+    _progress_file.reset(new std::ofstream(json_path));
+    if (!*_progress_file) {
+      std::cout << "[WARNING] Unable to Open Progress File \"" << json_path << "\".\n";
+      _progress_file.reset();
+    }
+  }
+  if (_progress_file) {
+    _progress.reset(new util::progress::reporter(threads, interval, true, *_progress_file));
+  } else {
+    _progress.reset(new util::progress::reporter(threads, interval));
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Start Progress Reporting for Run____________________________________________________________
+void EventAction::StartProgress(const size_t events) {
+  if (_progress)
+    _progress->start(events);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Stop Progress Reporting and Print Summary___________________________________________________
+void EventAction::StopProgress() {
+  if (_progress)
+    _progress->stop();
+}
+//----------------------------------------------------------------------------------------------
+
 } } /* namespace MATHUSLA::MU */
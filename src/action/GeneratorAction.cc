@@ -17,6 +17,8 @@
 
 #include "action.hh"
 
+#include <functional>
+#include <map>
 #include <unordered_map>
 
 #include <tls.hh>
@@ -27,39 +29,35 @@
 #include "physics/CORSIKAReaderGenerator.hh"
 #include "physics/PythiaGenerator.hh"
 #include "physics/HepMCGenerator.hh"
+#include "physics/SurfaceMuonGenerator.hh"
 #include "physics/Units.hh"
 
 namespace MATHUSLA { namespace MU {
 
 namespace { ////////////////////////////////////////////////////////////////////////////////////
 
-//__Generator Map_______________________________________________________________________________
-G4ThreadLocal std::unordered_map<std::string, Physics::Generator*> _gen_map;
-//----------------------------------------------------------------------------------------------
-
-//__Current Generator___________________________________________________________________________
-Physics::Generator* _gen;
+//__Generator Factory___________________________________________________________________________
+using GeneratorFactory = std::function<Physics::Generator*()>;
 //----------------------------------------------------------------------------------------------
 
-} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
-
-//__Generator Action Constructor________________________________________________________________
-GeneratorAction::GeneratorAction(const std::string& generator)
-    : G4VUserPrimaryGeneratorAction(),
-      G4UImessenger(Physics::Generator::MessengerDirectory, "Particle Generators.") {
-
-  _gen_map["basic"] = new Physics::Generator(
-      "basic", "Default Generator.", Physics::Particle(13, 0, 0, Earth::TotalShift() + Cavern::IP(), -3*GeVperC, 0, -100*GeVperC));
-
-  _gen_map["range"] = new Physics::RangeGenerator(
-      "range", "Default Range Generator.", {});
-
-  _gen_map["file_reader"] = new Physics::FileReaderGenerator(
-      "file_reader", "File Reader Generator.");
-
-  _gen_map["pythia"] = new Physics::PythiaGenerator(
-      {},
-      {
+//__Generator Registry__________________________________________________________________________
+const std::map<std::string, GeneratorFactory>& _registry() {
+  static const std::map<std::string, GeneratorFactory> registry{
+    {"basic", [] {
+      return new Physics::Generator(
+        "basic", "Default Generator.",
+        Physics::Particle(13, 0, 0, Earth::TotalShift() + Cavern::IP(), -3*GeVperC, 0, -100*GeVperC));
+    }},
+    {"range", [] {
+      return new Physics::RangeGenerator("range", "Default Range Generator.", {});
+    }},
+    {"file_reader", [] {
+      return new Physics::FileReaderGenerator("file_reader", "File Reader Generator.");
+    }},
+    {"pythia", [] {
+      return new Physics::PythiaGenerator(
+        {},
+        {
           "Print:quiet = on",
           "Next:numberCount = 10000",
           "Stat:showErrors = off",
@@ -67,16 +65,48 @@ GeneratorAction::GeneratorAction(const std::string& generator)
           "WeakSingleBoson:ffbar2W = on",
           "24:onMode = off",
           "24:onIfAny = 13"
-      });
+        });
+    }},
+#ifdef MU__USE_HEPMC3
+    {"hepmc", [] {
+      return new Physics::HepMCGenerator();
+    }},
+#endif
+    {"corsika_reader", [] {
+      return new Physics::CORSIKAReaderGenerator("");
+    }},
+    {"surface_muon", [] {
+      return new Physics::SurfaceMuonGenerator(
+        "surface_muon", "Sea-Level Muons Transferred through Rock.",
+        Physics::Particle(13, 0, 0, Earth::TotalShift() + Cavern::IP()));
+    }}
+  };
+  return registry;
+}
+//----------------------------------------------------------------------------------------------
 
-  // _gen_map["hepmc"] = new Physics::HepMCGenerator({});
+//__Constructed Generators for this Thread______________________________________________________
+G4ThreadLocal std::unordered_map<std::string, Physics::Generator*> _gen_map;
+//----------------------------------------------------------------------------------------------
 
-  _gen_map["corsika_reader"] = new Physics::CORSIKAReaderGenerator("");
+//__Current Generator for this Thread___________________________________________________________
+G4ThreadLocal Physics::Generator* _gen = nullptr;
+//----------------------------------------------------------------------------------------------
 
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Generator Action Constructor________________________________________________________________
+GeneratorAction::GeneratorAction(const std::string& generator)
+    : G4VUserPrimaryGeneratorAction(),
+      G4UImessenger(Physics::Generator::MessengerDirectory, "Particle Generators.") {
+  // every generator is constructed up front so its commands exist before it is selected, the
+  // heavy state like the Pythia object or a HepMC stream is only built by the first event
   std::string generators;
-  for (const auto& element : _gen_map) {
+  for (const auto& element : _registry()) {
     generators.append(element.first);
     generators.push_back(' ');
+    if (_gen_map.find(element.first) == _gen_map.end())
+      _gen_map[element.first] = element.second();
   }
 
   SetGenerator(generator);
@@ -108,8 +138,8 @@ void GeneratorAction::SetNewValue(G4UIcommand* command,
     SetGenerator(value);
   } else if (command == _list) {
     std::cout << "Generators: \n";
-    for (const auto& element : _gen_map)
-      std::cout << element.second << "\n";
+    for (const auto& element : _registry())
+      std::cout << *_gen_map[element.first] << "\n";
   } else if (command == _current) {
     std::cout << "Current Generator: \n  " << _gen->name() << "\n\n";
   }
@@ -130,8 +160,22 @@ Physics::ParticleVector GeneratorAction::GetLastEvent() {
 
 //__Set the Current Generator___________________________________________________________________
 void GeneratorAction::SetGenerator(const std::string& generator) {
-  const auto& search = _gen_map.find(generator);
-  _gen = (search != _gen_map.end()) ? search->second : _gen_map["basic"];
+  const auto search = _gen_map.find(generator);
+  if (search != _gen_map.end()) {
+    _gen = search->second;
+    return;
+  }
+
+  const auto& registry = _registry();
+  const auto factory = registry.find(generator);
+  if (factory == registry.end()) {
+    if (generator != "basic")
+      SetGenerator("basic");
+    return;
+  }
+
+  _gen = factory->second();
+  _gen_map[generator] = _gen;
 }
 //----------------------------------------------------------------------------------------------
 
@@ -18,7 +18,10 @@
 
 #include "action.hh"
 
+#include <algorithm>
+#include <chrono>
 #include <fstream>
+#include <map>
 #include <ostream>
 #include <thread>
 
@@ -28,14 +31,20 @@
 #include <tls.hh>
 
 #include <TFile.h>
+#include <TH2D.h>
 #include <TNamed.h>
+#include <TROOT.h>
 #include <TTree.h>
 #include <TChain.h>
 
 #include "analysis.hh"
 #include "geometry/Construction.hh"
+#include "physics/Builder.hh"
+#include "physics/SurfaceMuonGenerator.hh"
 #include "physics/Units.hh"
+#include "tracking.hh"
 
+#include "util/concurrent.hh"
 #include "util/io.hh"
 #include "util/time.hh"
 #include "util/stream.hh"
@@ -48,6 +57,7 @@ namespace { ////////////////////////////////////////////////////////////////////
 std::string _data_dir{};
 std::string _prefix{};
 std::string _path{};
+std::string _temp_prefix{};
 const std::string _temp_path = ".temp.root";
 std::vector<std::string> _worker_tags;
 bool _prefix_loaded = false;
@@ -59,6 +69,51 @@ std::size_t _event_count{};
 std::size_t _run_count{};
 //----------------------------------------------------------------------------------------------
 
+//__Thread Utilization for Current Run__________________________________________________________
+struct ThreadTime {
+  int thread;
+  double busy;
+  std::size_t events;
+  double setup;
+  double output;
+};
+std::vector<ThreadTime> _thread_times;
+std::chrono::steady_clock::time_point _run_start;
+//----------------------------------------------------------------------------------------------
+
+//__Ntuple Setup and Output File Time for Current Run on this Thread____________________________
+G4ThreadLocal double _setup_time{};
+G4ThreadLocal double _output_time{};
+//----------------------------------------------------------------------------------------------
+
+//__Seconds Since Time Point____________________________________________________________________
+double _seconds_since(const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Pending Output File Merge___________________________________________________________________
+// everything the merge needs is copied at the end of the run so the next run can change the
+// generator, physics list or detector while the merge is still in progress
+struct FinalizeJob {
+  std::string path;
+  std::string temp_prefix;
+  std::vector<std::string> worker_tags;
+  std::string data_name;
+  Analysis::SimSettingList entries;
+  SteppingAction::Profile profile;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Totals over All Runs________________________________________________________________________
+RunAction::Summary _summary{};
+G4Mutex _summary_mutex = G4MUTEX_INITIALIZER;
+//----------------------------------------------------------------------------------------------
+
+//__Background Output Finalizer_________________________________________________________________
+util::concurrent::serial_executor _finalizer;
+//----------------------------------------------------------------------------------------------
+
 //__Mutex for ROOT Interface____________________________________________________________________
 G4Mutex _mutex = G4MUTEX_INITIALIZER;
 //----------------------------------------------------------------------------------------------
@@ -92,6 +147,113 @@ std::string _make_directories(std::string prefix) {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Write Step Profile as Volume by Particle Histograms__________________________________________
+void _write_profile(TFile* file,
+                    const SteppingAction::Profile& profile) {
+  std::map<std::string, int> volumes, particles;
+  for (const auto& entry : profile) {
+    volumes.insert({entry.volume, 0});
+    particles.insert({entry.particle, 0});
+  }
+  int index{};
+  for (auto& volume : volumes)
+    volume.second = ++index;
+  index = 0;
+  for (auto& particle : particles)
+    particle.second = ++index;
+
+  auto directory = file->mkdir("profile");
+  directory->cd();
+
+  const auto make = [&](const char* name, const char* title) {
+    const auto nx = static_cast<int>(volumes.size());
+    const auto ny = static_cast<int>(particles.size());
+    auto histogram = new TH2D(name, title, nx, 0, nx, ny, 0, ny);
+    histogram->SetDirectory(directory);
+    for (const auto& volume : volumes)
+      histogram->GetXaxis()->SetBinLabel(volume.second, volume.first.c_str());
+    for (const auto& particle : particles)
+      histogram->GetYaxis()->SetBinLabel(particle.second, particle.first.c_str());
+    return histogram;
+  };
+  auto steps   = make("steps",   "Steps;Volume;Particle");
+  auto length  = make("length",  "Track Length [m];Volume;Particle");
+  auto deposit = make("deposit", "Energy Deposit [MeV];Volume;Particle");
+  auto time    = make("time",    "Step Time [s];Volume;Particle");
+
+  for (const auto& entry : profile) {
+    const auto x = volumes[entry.volume];
+    const auto y = particles[entry.particle];
+    steps->SetBinContent(x, y, entry.steps);
+    length->SetBinContent(x, y, entry.length / m);
+    deposit->SetBinContent(x, y, entry.deposit / MeV);
+    time->SetBinContent(x, y, entry.time);
+  }
+
+  directory->Write();
+  file->cd();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Merge Worker Files and Write Run Metadata___________________________________________________
+void _finalize(const FinalizeJob& job) {
+  const auto start = std::chrono::steady_clock::now();
+  auto file = TFile::Open(job.path.c_str(), "UPDATE");
+  if (!file || file->IsZombie()) {
+    std::cout << "[WARNING] Unable to Write Data File " << job.path << ".\n";
+    delete file;
+    return;
+  }
+
+  file->cd();
+  auto chain = new TChain(job.data_name.c_str());
+  for (const auto& tag : job.worker_tags)
+    chain->Add((job.temp_prefix + tag).c_str());
+
+  TTree* tree = chain;
+  file->cd();
+  auto clone_tree = tree->CloneTree();
+  if (clone_tree)
+    clone_tree->Write();
+  delete chain;
+
+  util::io::remove_file(job.temp_prefix + _temp_path);
+  for (const auto& tag : job.worker_tags)
+    util::io::remove_file(job.temp_prefix + tag);
+
+  file->cd();
+  for (const auto& entry : job.entries)
+    _write_entry(file, entry.name, entry.text);
+
+  if (!job.profile.empty())
+    _write_profile(file, job.profile);
+
+  file->Close();
+  delete file;
+
+  G4AutoLock lock(&_summary_mutex);
+  _summary.merge_time += _seconds_since(start);
+  _summary.output_bytes += util::io::file_size(job.path);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Print Busy and Idle Time for Each Worker____________________________________________________
+void _print_thread_times(double wall) {
+  if (_thread_times.empty())
+    return;
+  std::sort(_thread_times.begin(), _thread_times.end(),
+    [](const ThreadTime& left, const ThreadTime& right) { return left.thread < right.thread; });
+  std::cout << "Thread Utilization (wall " << wall << " s):\n";
+  for (const auto& entry : _thread_times) {
+    std::cout << "  Thread " << entry.thread << ": "
+              << entry.events << " events, busy " << entry.busy << " s, idle "
+              << std::max(0.0, wall - entry.busy) << " s ("
+              << (wall > 0 ? 100.0 * entry.busy / wall : 0.0) << "% busy), ntuple setup "
+              << 1000 * entry.setup << " ms, output file " << 1000 * entry.output << " ms\n";
+  }
+}
+//----------------------------------------------------------------------------------------------
+
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 //__RunAction Constructor_______________________________________________________________________
@@ -102,6 +264,9 @@ RunAction::RunAction(const std::string& data_dir) : G4UserRunAction() {
   _worker_tags.reserve(_worker_count);
   for (std::size_t i = 0; i < _worker_count; ++i)
     _worker_tags.push_back(".temp_t" + std::to_string(i) + ".root");
+  // the finalizer runs ROOT I/O alongside the workers
+  if (!G4Threading::IsWorkerThread())
+    ::ROOT::EnableThreadSafety();
 }
 //----------------------------------------------------------------------------------------------
 
@@ -112,16 +277,30 @@ void RunAction::BeginOfRunAction(const G4Run* run) {
     if (_prefix.find("/run") == std::string::npos)
       _prefix = _make_directories(_data_dir) + "/run";
     _path = _prefix + std::to_string(_run_count) + ".root";
+    _temp_prefix = _prefix + std::to_string(_run_count);
     _event_count = run->GetNumberOfEventToBeProcessed();
+    _thread_times.clear();
+    _run_start = std::chrono::steady_clock::now();
+    SteppingAction::PrepareProfile(_worker_count);
+    Tracking::Memory::Prepare(_worker_count);
+    Physics::SurfaceMuonGenerator::ResetCounters();
+    EventAction::StartProgress(_event_count);
   }
+  const auto temp_path = _temp_prefix + _temp_path;
   lock.unlock();
+  EventAction::ResetBusyTime();
 
-  Analysis::ROOT::Setup();
-  Analysis::ROOT::Open(_prefix + _temp_path);
-  Analysis::ROOT::CreateNTuple(
+  // the ntuple schema is kept between runs and only the output file is rotated
+  const auto setup_start = std::chrono::steady_clock::now();
+  Analysis::ROOT::Book(
     Construction::Builder::GetDetectorDataName(),
     Construction::Builder::GetDetectorDataKeys(),
     Construction::Builder::GetDetectorDataKeyTypes());
+  _setup_time = _seconds_since(setup_start);
+
+  const auto open_start = std::chrono::steady_clock::now();
+  Analysis::ROOT::Open(temp_path);
+  _output_time = _seconds_since(open_start);
 
   if (!G4Threading::IsWorkerThread())
     std::cout << "\n\n";
@@ -130,56 +309,92 @@ void RunAction::BeginOfRunAction(const G4Run* run) {
 
 //__Post-Run Processing_________________________________________________________________________
 void RunAction::EndOfRunAction(const G4Run*) {
-  if (!_event_count)
-    return;
+  const auto wall = _seconds_since(_run_start);
+  if (!G4Threading::IsWorkerThread())
+    EventAction::StopProgress();
 
+  // the file is closed even for empty runs since the analysis manager outlives the run
+  const auto save_start = std::chrono::steady_clock::now();
   Analysis::ROOT::Save();
+  _output_time += _seconds_since(save_start);
+
+  if (G4Threading::IsWorkerThread()) {
+    SteppingAction::PublishProfile();
+    Tracking::Memory::Publish();
+    G4AutoLock lock(&_mutex);
+    _thread_times.push_back({G4Threading::G4GetThreadId(), EventAction::BusyTime(),
+                             EventAction::EventsProcessed(), _setup_time, _output_time});
+  }
+
+  if (!_event_count) {
+    if (!G4Threading::IsWorkerThread())
+      util::io::remove_file(_temp_prefix + _temp_path);
+    return;
+  }
+
+  StackingAction::MergeKillCounts();
 
   G4AutoLock lock(&_mutex);
   if (!G4Threading::IsWorkerThread()) {
     if (util::io::path_exists(_path))
       return;
-    auto file = TFile::Open(_path.c_str(), "UPDATE");
-    if (file && !file->IsZombie()) {
-      file->cd();
-      auto chain = new TChain(Construction::Builder::GetDetectorDataName().c_str());
-      for (const auto& tag : _worker_tags)
-        chain->Add((_prefix + tag).c_str());
-
-      TTree* tree = chain;
-      file->cd();
-      auto clone_tree = tree->CloneTree();
-      if (clone_tree)
-        clone_tree->Write();
-      delete chain;
-
-      util::io::remove_file(_prefix + _temp_path);
-      for (const auto& tag : _worker_tags)
-        util::io::remove_file(_prefix + tag);
-
-      file->cd();
-
-      _write_entry(file, "FILETYPE", "MATHULSA MU-SIM DATAFILE");
-      _write_entry(file, "DET", Construction::Builder::GetDetectorName());
-
-      for (const auto& entry : GeneratorAction::GetGenerator()->GetSpecification())
-        _write_entry(file, entry.name, entry.text);
-
-      _write_entry(file, "RUN", _run_count);
-      _write_entry(file, "EVENTS", _event_count);
-      _write_entry(file, "TIMESTAMP", util::time::GetString("%c %Z"));
 
-      file->Close();
-
-      ++_run_count;
-      std::cout << "\n\n\nEnd of Run\nData File: " << _path << "\n\n";
+    FinalizeJob job{_path, _temp_prefix, _worker_tags,
+                    Construction::Builder::GetDetectorDataName(), {},
+                    SteppingAction::MergeProfile()};
+    job.entries.emplace_back("FILETYPE", "MATHULSA MU-SIM DATAFILE");
+    job.entries.emplace_back("DET", Construction::Builder::GetDetectorName());
+    job.entries.emplace_back("TRUTH", Tracking::GetTruthLevelName());
+    for (const auto& entry : GeneratorAction::GetGenerator()->GetSpecification())
+      job.entries.push_back(entry);
+    for (const auto& entry : Physics::Builder::GetSpecification())
+      job.entries.push_back(entry);
+    const auto memory = Tracking::Memory::Merge();
+    for (const auto& entry : Tracking::Memory::Specification(memory))
+      job.entries.push_back(entry);
+    job.entries.emplace_back("RUN", std::to_string(_run_count));
+    job.entries.emplace_back("EVENTS", std::to_string(_event_count));
+    job.entries.emplace_back("TIMESTAMP", util::time::GetString("%c %Z"));
+
+    // merging only touches this run's files, so the next run can start while it is written
+    _finalizer.push([job]{ _finalize(job); });
+
+    ++_run_count;
+    {
+      G4AutoLock summary_lock(&_summary_mutex);
+      ++_summary.runs;
+      _summary.events += _event_count;
+      _summary.run_time += wall;
+      for (const auto& entry : job.profile) {
+        _summary.steps += entry.steps;
+        _summary.step_time += entry.time;
+      }
     }
+    std::cout << "\n\n\nEnd of Run\nData File: " << _path << "\n\n";
+    StackingAction::PrintKillCounts();
+    Tracking::Trigger::PrintCounts();
+    _print_thread_times(wall);
+    Tracking::Memory::Print(memory);
+    SteppingAction::PrintProfile(job.profile);
   }
   lock.unlock();
   _prefix_loaded = false;
 }
 //----------------------------------------------------------------------------------------------
 
+//__Wait for Background Output Merges___________________________________________________________
+void RunAction::WaitForFinalization() {
+  _finalizer.wait();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Totals over All Runs____________________________________________________________________
+RunAction::Summary RunAction::GetSummary() {
+  G4AutoLock lock(&_summary_mutex);
+  return _summary;
+}
+//----------------------------------------------------------------------------------------------
+
 //__Get Current Run_____________________________________________________________________________
 const G4Run* RunAction::GetRun() {
   return G4RunManager::GetRunManager()->GetCurrentRun();
@@ -0,0 +1,322 @@
+/*
+ * src/action/StackingAction.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "action.hh"
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+#include <G4AutoLock.hh>
+#include <G4Neutron.hh>
+#include <G4Gamma.hh>
+#include <G4GeometryTolerance.hh>
+#include <G4Navigator.hh>
+#include <G4RegionStore.hh>
+#include <G4TransportationManager.hh>
+#include <G4UnitsTable.hh>
+#include <tls.hh>
+
+#include "geometry/Construction.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Stacking Settings___________________________________________________________________________
+G4ThreadLocal bool _enabled = false;
+G4ThreadLocal bool _range_check = false;
+G4ThreadLocal G4ClassificationOfNewTrack _neutron_stack = fUrgent;
+G4ThreadLocal G4ClassificationOfNewTrack _gamma_stack = fUrgent;
+G4ThreadLocal std::unordered_map<std::string, double>* _thresholds = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__Stack Policy Names__________________________________________________________________________
+const std::string _policies = "urgent waiting kill";
+//----------------------------------------------------------------------------------------------
+
+//__Kill Counters per Particle__________________________________________________________________
+struct KillCount {
+  std::size_t threshold;
+  std::size_t range;
+  std::size_t dropped;
+};
+using KillCountMap = std::map<std::string, KillCount>;
+G4ThreadLocal KillCountMap* _thread_counts = nullptr;
+KillCountMap _run_counts;
+G4Mutex _count_mutex = G4MUTEX_INITIALIZER;
+//----------------------------------------------------------------------------------------------
+
+//__Get Thread Local Threshold Map______________________________________________________________
+std::unordered_map<std::string, double>& _get_thresholds() {
+  if (!_thresholds)
+    _thresholds = new std::unordered_map<std::string, double>;
+  return *_thresholds;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Thread Local Kill Counter for Particle__________________________________________________
+KillCount& _count(const std::string& particle) {
+  if (!_thread_counts)
+    _thread_counts = new KillCountMap;
+  return (*_thread_counts)[particle];
+}
+//----------------------------------------------------------------------------------------------
+
+//__Convert Stack Policy to Classification______________________________________________________
+G4ClassificationOfNewTrack _to_classification(const std::string& policy) {
+  if (policy == "waiting")
+    return fWaiting;
+  else if (policy == "kill")
+    return fKill;
+  return fUrgent;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Closest Point of Detector Envelope__________________________________________________________
+G4ThreeVector _closest_detector_point(const G4ThreeVector& point) {
+  const auto& lower = Construction::Builder::GetDetectorEnvelopeMin();
+  const auto& upper = Construction::Builder::GetDetectorEnvelopeMax();
+  return G4ThreeVector(std::min(std::max(point.x(), lower.x()), upper.x()),
+                       std::min(std::max(point.y(), lower.y()), upper.y()),
+                       std::min(std::max(point.z(), lower.z()), upper.z()));
+}
+//----------------------------------------------------------------------------------------------
+
+//__Navigator for Range Check Paths_____________________________________________________________
+G4ThreadLocal G4Navigator* _navigator = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__Fraction of Range Spent in Earth on the Way to the Detector_________________________________
+// walks the straight line to the closest point of the envelope and adds up the length of each
+// earth volume over the range in its material, so the air of the cavern never counts against
+// the particle. The walk stops as soon as the range is used up.
+double _earth_range_fraction(G4EmCalculator& calculator,
+                             const G4Region* earth,
+                             const G4ParticleDefinition* particle,
+                             const double energy,
+                             G4ThreeVector point) {
+  const auto target = _closest_detector_point(point);
+  auto remaining = (target - point).mag();
+  if (remaining <= 0)
+    return 0;
+  const auto direction = (target - point).unit();
+
+  const auto tolerance = G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+  double fraction{}, safety{};
+  bool relocate = false;
+  while (remaining > 0 && fraction < 1) {
+    const auto volume = _navigator->LocateGlobalPointAndSetup(point, &direction, relocate, false);
+    relocate = true;
+    if (!volume)
+      break;
+    auto step = _navigator->ComputeStep(point, direction, remaining, safety);
+    step = std::max(std::min(step, remaining), 0.0);
+
+    const auto logical = volume->GetLogicalVolume();
+    if (logical->GetRegion() == earth) {
+      const auto range = calculator.GetRange(energy, particle, logical->GetMaterial(), earth);
+      if (range > 0)
+        fraction += step / range;
+    }
+
+    // a zero step on a boundary is pushed past it by the surface tolerance
+    step = std::max(step, tolerance);
+    point += step * direction;
+    remaining -= step;
+    _navigator->SetGeometricallyLimitedStep();
+  }
+  return fraction;
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Stacking Messenger Directory Path___________________________________________________________
+const std::string StackingAction::MessengerDirectory = "/stack/";
+//----------------------------------------------------------------------------------------------
+
+//__Stacking Action Constructor_________________________________________________________________
+StackingAction::StackingAction()
+    : G4UserStackingAction(), G4UImessenger(MessengerDirectory, "Track Stacking and Killing."),
+      _earth(nullptr) {
+  _calculator.SetVerbose(0);
+
+  _enable = CreateCommand<Command::BoolArg>("enable", "Enable Track Killing.");
+  _enable->SetParameterName("enable", false);
+  _enable->SetDefaultValue(false);
+  _enable->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _range = CreateCommand<Command::BoolArg>("range", "Kill Charged Tracks Which Cannot Reach the Detector.");
+  _range->SetParameterName("range", false);
+  _range->SetDefaultValue(false);
+  _range->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _threshold = CreateCommand<Command::StringArg>("threshold", "Set Earth Kinetic Energy Threshold for Particle.");
+  _threshold->SetParameterName("particle energy unit", false);
+  _threshold->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _clear = CreateCommand<Command::NoArg>("clear_thresholds", "Clear Earth Energy Thresholds.");
+  _clear->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _neutron = CreateCommand<Command::StringArg>("neutron", "Set Stack for Secondary Neutrons.");
+  _neutron->SetParameterName("policy", false);
+  _neutron->SetDefaultValue("urgent");
+  _neutron->SetCandidates(_policies.c_str());
+  _neutron->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _gamma = CreateCommand<Command::StringArg>("gamma", "Set Stack for Secondary Photons.");
+  _gamma->SetParameterName("policy", false);
+  _gamma->SetDefaultValue("urgent");
+  _gamma->SetCandidates(_policies.c_str());
+  _gamma->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _print = CreateCommand<Command::NoArg>("print", "Print Stacking Settings.");
+  _print->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Classify New Track__________________________________________________________________________
+G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track* track) {
+  if (!_enabled || !track->GetParentID())
+    return fUrgent;
+
+  const auto particle = track->GetParticleDefinition();
+  const auto volume = track->GetVolume();
+
+  if (volume) {
+    const auto logical = volume->GetLogicalVolume();
+    const auto energy = track->GetKineticEnergy();
+
+    if (_earth && logical->GetRegion() == _earth) {
+      const auto& thresholds = _get_thresholds();
+      const auto search = thresholds.find(particle->GetParticleName());
+      if (search != thresholds.cend() && energy < search->second) {
+        ++_count(particle->GetParticleName()).threshold;
+        return fKill;
+      }
+    }
+
+    if (_range_check && _earth && _navigator && particle->GetPDGCharge() != 0 && !particle->IsShortLived()) {
+      const auto& position = track->GetPosition();
+      const auto distance = (_closest_detector_point(position) - position).mag();
+      // the range in the birth material covering the whole distance already rules out a kill
+      const auto range = _calculator.GetRange(energy, particle, logical->GetMaterial(), logical->GetRegion());
+      if (distance > 0 && range > 0 && range < distance
+          && _earth_range_fraction(_calculator, _earth, particle, energy, position) >= 1) {
+        ++_count(particle->GetParticleName()).range;
+        return fKill;
+      }
+    }
+  }
+
+  auto out = fUrgent;
+  if (particle == G4Neutron::Definition())
+    out = _neutron_stack;
+  else if (particle == G4Gamma::Definition())
+    out = _gamma_stack;
+
+  if (out == fKill)
+    ++_count(particle->GetParticleName()).dropped;
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Prepare Stacks for New Event________________________________________________________________
+void StackingAction::PrepareNewEvent() {
+  _earth = G4RegionStore::GetInstance()->GetRegion("Earth", false);
+  if (_range_check) {
+    if (!_navigator)
+      _navigator = new G4Navigator;
+    const auto world = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
+    if (_navigator->GetWorldVolume() != world)
+      _navigator->SetWorldVolume(world);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Stacking Messenger Set New Value____________________________________________________________
+void StackingAction::SetNewValue(G4UIcommand* command, G4String value) {
+  if (command == _enable) {
+    _enabled = _enable->GetNewBoolValue(value);
+  } else if (command == _range) {
+    _range_check = _range->GetNewBoolValue(value);
+  } else if (command == _threshold) {
+    std::istringstream stream(value);
+    std::string particle, unit;
+    double energy;
+    if (stream >> particle >> energy >> unit) {
+      SetThreshold(particle, energy * G4UIcommand::ValueOf(unit.c_str()));
+    } else {
+      std::cout << "[WARNING] Expected \"<particle> <energy> <unit>\" for Threshold.\n";
+    }
+  } else if (command == _clear) {
+    _get_thresholds().clear();
+  } else if (command == _neutron) {
+    _neutron_stack = _to_classification(value);
+  } else if (command == _gamma) {
+    _gamma_stack = _to_classification(value);
+  } else if (command == _print) {
+    std::cout << "Track Killing: " << (_enabled ? "on" : "off")
+              << ", range check: " << (_range_check ? "on" : "off") << "\n";
+    for (const auto& entry : _get_thresholds())
+      std::cout << "  Earth threshold " << entry.first << ": " << G4BestUnit(entry.second, "Energy") << "\n";
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Earth Kinetic Energy Threshold__________________________________________________________
+void StackingAction::SetThreshold(const std::string& particle,
+                                  double energy) {
+  _get_thresholds()[particle] = energy;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Merge Thread Kill Counts into Run Counts____________________________________________________
+void StackingAction::MergeKillCounts() {
+  if (!_thread_counts)
+    return;
+  G4AutoLock lock(&_count_mutex);
+  for (const auto& entry : *_thread_counts) {
+    auto& count = _run_counts[entry.first];
+    count.threshold += entry.second.threshold;
+    count.range     += entry.second.range;
+    count.dropped   += entry.second.dropped;
+  }
+  _thread_counts->clear();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Print and Reset Run Kill Counts_____________________________________________________________
+void StackingAction::PrintKillCounts(std::ostream& os) {
+  G4AutoLock lock(&_count_mutex);
+  if (_run_counts.empty())
+    return;
+  os << "Killed Tracks (threshold / range / dropped):\n";
+  for (const auto& entry : _run_counts) {
+    os << "  " << entry.first << ": "
+       << entry.second.threshold << " / "
+       << entry.second.range << " / "
+       << entry.second.dropped << "\n";
+  }
+  _run_counts.clear();
+}
+//----------------------------------------------------------------------------------------------
+
+} } /* namespace MATHUSLA::MU */
@@ -0,0 +1,268 @@
+/*
+ * src/action/SteppingAction.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "action.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+#include <G4EventManager.hh>
+#include <G4LogicalVolume.hh>
+#include <G4Step.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4Threading.hh>
+#include <tls.hh>
+
+#include "tracking.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Profiler Settings___________________________________________________________________________
+G4ThreadLocal bool _enabled = false;
+G4ThreadLocal bool _timing_enabled = true;
+G4ThreadLocal std::size_t _print_rows = 20;
+//----------------------------------------------------------------------------------------------
+
+//__Step Statistics for One Volume and Particle_________________________________________________
+struct StepStats {
+  std::size_t steps;
+  double length;
+  double deposit;
+  double time;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Thread Local Statistics Keyed by Pointers___________________________________________________
+using StatsKey = std::pair<const G4LogicalVolume*, const G4ParticleDefinition*>;
+struct StatsKeyHash {
+  std::size_t operator()(const StatsKey& key) const {
+    return std::hash<const void*>()(key.first) ^ (std::hash<const void*>()(key.second) << 1);
+  }
+};
+using StatsMap = std::unordered_map<StatsKey, StepStats, StatsKeyHash>;
+G4ThreadLocal StatsMap* _thread_stats = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__Last Accessed Statistics Entry______________________________________________________________
+// consecutive steps mostly share volume and particle, so the last entry skips the hash lookup,
+// unordered_map nodes are stable so the pointer survives later insertions
+G4ThreadLocal StepStats* _last_stats = nullptr;
+G4ThreadLocal const G4LogicalVolume* _last_volume = nullptr;
+G4ThreadLocal const G4ParticleDefinition* _last_particle = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__Step Clock__________________________________________________________________________________
+using step_clock = std::chrono::steady_clock;
+G4ThreadLocal step_clock::rep _last_time{};
+G4ThreadLocal const G4Event* _last_event = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__Published Worker Profiles___________________________________________________________________
+// each worker writes only its own slot after its last event, and the master reads the slots
+// after all workers have finished the run, so no lock is needed
+using NamedProfile = std::map<std::pair<std::string, std::string>, StepStats>;
+std::vector<NamedProfile> _published;
+//----------------------------------------------------------------------------------------------
+
+//__Get Thread Local Statistics Entry___________________________________________________________
+StepStats& _stats(const G4LogicalVolume* volume,
+                  const G4ParticleDefinition* particle) {
+  if (_last_stats && volume == _last_volume && particle == _last_particle)
+    return *_last_stats;
+  if (!_thread_stats)
+    _thread_stats = new StatsMap;
+  _last_volume = volume;
+  _last_particle = particle;
+  _last_stats = &(*_thread_stats)[{volume, particle}];
+  return *_last_stats;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Add Statistics______________________________________________________________________________
+void _add(StepStats& total,
+          const StepStats& stats) {
+  total.steps   += stats.steps;
+  total.length  += stats.length;
+  total.deposit += stats.deposit;
+  total.time    += stats.time;
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Profiler Messenger Directory Path___________________________________________________________
+const std::string SteppingAction::MessengerDirectory = "/prof/";
+//----------------------------------------------------------------------------------------------
+
+//__Stepping Action Constructor_________________________________________________________________
+SteppingAction::SteppingAction()
+    : G4UserSteppingAction(), G4UImessenger(MessengerDirectory, "Simulation Profiler.") {
+  _enable = CreateCommand<Command::BoolArg>("enable", "Enable Per-Volume and Per-Particle Step Profiler.");
+  _enable->SetParameterName("enable", false);
+  _enable->SetDefaultValue(false);
+  _enable->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _timing = CreateCommand<Command::BoolArg>("timing", "Measure Wall Time per Step.");
+  _timing->SetParameterName("timing", false);
+  _timing->SetDefaultValue(true);
+  _timing->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _rows = CreateCommand<Command::IntegerArg>("rows", "Number of Profile Rows Printed at End of Run.");
+  _rows->SetParameterName("rows", false);
+  _rows->SetDefaultValue(20);
+  _rows->SetRange("rows >= 0");
+  _rows->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _memory = CreateCommand<Command::BoolArg>("memory", "Record Hit Memory and Allocator Usage per Thread.");
+  _memory->SetParameterName("memory", false);
+  _memory->SetDefaultValue(false);
+  _memory->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Record Step_________________________________________________________________________________
+void SteppingAction::UserSteppingAction(const G4Step* step) {
+  if (!_enabled)
+    return;
+
+  const auto point = step->GetPreStepPoint();
+  const auto physical = point->GetPhysicalVolume();
+  auto& stats = _stats(physical ? physical->GetLogicalVolume() : nullptr,
+                       step->GetTrack()->GetParticleDefinition());
+  ++stats.steps;
+  stats.length  += step->GetStepLength();
+  stats.deposit += step->GetTotalEnergyDeposit();
+
+  if (_timing_enabled) {
+    // time since the previous step of this event is charged to this step
+    const auto now = step_clock::now().time_since_epoch().count();
+    const auto event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+    if (event == _last_event)
+      stats.time += now - _last_time;
+    _last_event = event;
+    _last_time = now;
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Profiler Messenger Set New Value____________________________________________________________
+void SteppingAction::SetNewValue(G4UIcommand* command, G4String value) {
+  if (command == _enable) {
+    _enabled = _enable->GetNewBoolValue(value);
+  } else if (command == _timing) {
+    _timing_enabled = _timing->GetNewBoolValue(value);
+  } else if (command == _rows) {
+    _print_rows = static_cast<std::size_t>(_rows->GetNewIntValue(value));
+  } else if (command == _memory) {
+    Tracking::Memory::Enable(_memory->GetNewBoolValue(value));
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Profiler is Enabled on this Thread_________________________________________________
+bool SteppingAction::ProfileEnabled() {
+  return _enabled;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Reset Published Profiles for New Run________________________________________________________
+void SteppingAction::PrepareProfile(std::size_t threads) {
+  _published.clear();
+  _published.resize(threads);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Publish Thread Profile at End of Run________________________________________________________
+void SteppingAction::PublishProfile() {
+  _last_stats = nullptr;
+  _last_event = nullptr;
+  if (!_thread_stats)
+    return;
+
+  const auto id = G4Threading::G4GetThreadId();
+  if (id >= 0 && static_cast<std::size_t>(id) < _published.size()) {
+    auto& slot = _published[id];
+    for (const auto& entry : *_thread_stats) {
+      const auto volume = entry.first.first;
+      _add(slot[{volume ? std::string(volume->GetName()) : "OutOfWorld",
+                 entry.first.second->GetParticleName()}], entry.second);
+    }
+  }
+  _thread_stats->clear();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Merge Published Profiles____________________________________________________________________
+SteppingAction::Profile SteppingAction::MergeProfile() {
+  NamedProfile merged;
+  for (const auto& slot : _published)
+    for (const auto& entry : slot)
+      _add(merged[entry.first], entry.second);
+  _published.clear();
+
+  const auto to_seconds = static_cast<double>(step_clock::period::num) / step_clock::period::den;
+  Profile out;
+  out.reserve(merged.size());
+  for (const auto& entry : merged) {
+    out.push_back({entry.first.first, entry.first.second, entry.second.steps,
+                   entry.second.length, entry.second.deposit, entry.second.time * to_seconds});
+  }
+  std::sort(out.begin(), out.end(), [](const ProfileEntry& left, const ProfileEntry& right) {
+    return left.time != right.time ? left.time > right.time : left.steps > right.steps; });
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Print Profile Table_________________________________________________________________________
+void SteppingAction::PrintProfile(const Profile& profile,
+                                  std::ostream& os) {
+  if (profile.empty())
+    return;
+
+  std::size_t steps{};
+  double time{};
+  for (const auto& entry : profile) {
+    steps += entry.steps;
+    time += entry.time;
+  }
+
+  os << "Step Profile (" << steps << " steps, " << time << " s):\n"
+     << "  " << std::left << std::setw(28) << "Volume" << std::setw(14) << "Particle" << std::right
+     << std::setw(14) << "Steps" << std::setw(14) << "Length [m]"
+     << std::setw(14) << "Deposit [MeV]" << std::setw(12) << "Time [s]" << std::setw(9) << "Time %" << "\n";
+  const auto rows = std::min(_print_rows, profile.size());
+  for (std::size_t i{}; i < rows; ++i) {
+    const auto& entry = profile[i];
+    os << "  " << std::left << std::setw(28) << entry.volume << std::setw(14) << entry.particle << std::right
+       << std::setw(14) << entry.steps << std::setw(14) << entry.length / m
+       << std::setw(14) << entry.deposit / MeV << std::setw(12) << entry.time
+       << std::setw(9) << (time > 0 ? 100 * entry.time / time : 0.0) << "\n";
+  }
+  if (rows < profile.size())
+    os << "  ... " << profile.size() - rows << " more entries in the data file\n";
+}
+//----------------------------------------------------------------------------------------------
+
+} } /* namespace MATHUSLA::MU */
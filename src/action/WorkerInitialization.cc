@@ -0,0 +1,73 @@
+/* src/action/WorkerInitialization.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "action.hh"
+
+#include <G4AutoLock.hh>
+#include <G4Threading.hh>
+
+#include "util/thread.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+//__Pinning Mode________________________________________________________________________________
+bool _numa;
+//----------------------------------------------------------------------------------------------
+
+//__Pinning Report Mutex________________________________________________________________________
+G4Mutex _pin_mutex = G4MUTEX_INITIALIZER;
+//----------------------------------------------------------------------------------------------
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Worker Initialization Constructor___________________________________________________________
+WorkerInitialization::WorkerInitialization(const std::string& pin_mode)
+    : G4UserWorkerInitialization() {
+  _numa = pin_mode == "numa";
+}
+//----------------------------------------------------------------------------------------------
+
+//__Pin Worker Thread Before Geometry and Physics are Built_____________________________________
+void WorkerInitialization::WorkerInitialize() const {
+  const auto id = G4Threading::G4GetThreadId();
+  if (id < 0)
+    return;
+
+  util::thread::cpu_list cpus;
+  if (_numa) {
+    const auto nodes = util::thread::numa_nodes();
+    if (!nodes.empty())
+      cpus = nodes[id % nodes.size()];
+  } else {
+    const auto allowed = util::thread::allowed_cpus();
+    if (!allowed.empty())
+      cpus = {allowed[id % allowed.size()]};
+  }
+
+  const auto pinned = !cpus.empty() && util::thread::pin_current_thread(cpus);
+
+  G4AutoLock lock(&_pin_mutex);
+  if (pinned) {
+    std::cout << "Worker " << id << " Pinned to CPU "
+              << util::thread::format_cpu_list(cpus) << "\n";
+  } else {
+    std::cout << "[WARNING] Unable to Pin Worker " << id << ".\n";
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+} } /* namespace MATHUSLA::MU */
@@ -67,6 +67,10 @@ G4ThreadLocal std::unordered_map<std::string, int> _ntuple;
 G4ThreadLocal std::unordered_map<std::string, DataEntryList> _ntuple_data;
 //----------------------------------------------------------------------------------------------
 
+//__Booked NTuple Schema________________________________________________________________________
+G4ThreadLocal std::string _schema;
+//----------------------------------------------------------------------------------------------
+
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 //__Setup ROOT Analysis Tool____________________________________________________________________
@@ -122,6 +126,27 @@ bool CreateNTuple(const std::string& name,
 }
 //----------------------------------------------------------------------------------------------
 
+//__Persistent NTuple Initializer_______________________________________________________________
+bool Book(const std::string& name,
+          const DataKeyList& columns,
+          const DataKeyTypeList& types) {
+  std::string schema = name;
+  for (std::size_t i{}; i < columns.size(); ++i) {
+    schema.push_back(i < types.size() && types[i] == DataKeyType::Vector ? '[' : ':');
+    schema += columns[i];
+  }
+
+  if (_schema == schema)
+    return false;
+
+  Setup();
+  _ntuple_data.clear();
+  CreateNTuple(name, columns, types);
+  _schema = schema;
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
 //__Fill ROOT NTuple____________________________________________________________________________
 bool FillNTuple(const std::string& name,
                 const DataKeyTypeList& types,
@@ -154,6 +179,16 @@ bool FillNTuple(const std::string& name,
 }
 //----------------------------------------------------------------------------------------------
 
+//__Bytes Reserved by NTuple Columns on this Thread_____________________________________________
+std::size_t DataCapacity() {
+  std::size_t out{};
+  for (const auto& entry : _ntuple_data)
+    for (const auto& column : entry.second)
+      out += sizeof(column) + column.capacity() * sizeof(DataEntryValueType);
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
 } /* namespace ROOT */ /////////////////////////////////////////////////////////////////////////
 
 } /* namespace Analysis */ /////////////////////////////////////////////////////////////////////
@@ -4,20 +4,28 @@
 #include "G4Trap.hh"
 #include "G4Box.hh"
 
+#include "G4VPVParameterisation.hh"
+#include "G4ReplicaNavigation.hh"
+
 #include "geometry/Construction.hh"
+#include "geometry/Prototype.hh"
+#include "geometry/PrototypeTable.hh"
+
+#include "util/spatial_index.hh"
 
 #include <string>
-#include <cctype>
+#include <vector>
 #include <iostream>
 
 bool is_scintillator_name(const std::string &name) {
+  return MATHUSLA::MU::Prototype::Table::ScintillatorID(name.c_str()) >= 0;
+}
+
+bool is_strip_volume(const std::string &name) {
+  const std::string suffix = "_Strip";
   if (
-       name.size() == 5
-    && name[0] == 'S'
-    && (name[1] == 'A' || name[1] == 'B')
-    && std::isdigit(name[2])
-    && name[3] == '-'
-    && std::isdigit(name[4])
+       name.size() > suffix.size()
+    && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0
   ) {
     return true;
   } else {
@@ -25,26 +33,38 @@ bool is_scintillator_name(const std::string &name) {
   }
 }
 
-bool is_strip_name(const std::string &name) {
-  if (
-       name.size() == 5
-    && std::isdigit(name[0])
-    && std::isdigit(name[1])
-    && std::isdigit(name[2])
-    && std::isdigit(name[3])
-    && std::isdigit(name[4])
-  ) {
-    return true;
-  } else {
-    return false;
+// copy_numbers holds the copy number of every volume from the world down to this one; strips are
+// replicated in a pad, which is parameterised in the pad plane of an RPC
+std::string volume_name(const G4LogicalVolume &logical_volume, const std::vector<G4int> &copy_numbers) {
+  const auto &name = logical_volume.GetName();
+  const auto depth = copy_numbers.size();
+  if (is_strip_volume(name) && depth >= 4) {
+    return MATHUSLA::MU::Prototype::Table::DecodeDetector(
+      MATHUSLA::MU::Prototype::Table::StripID(copy_numbers[depth - 4], copy_numbers[depth - 2], copy_numbers[depth - 1]));
   }
+  return name;
+}
+
+MATHUSLA::util::spatial::point to_point(const G4ThreeVector &vector) {
+  return {{vector.x(), vector.y(), vector.z()}};
 }
 
-void dump_volume(const G4VPhysicalVolume &physical_volume, const G4ThreeVector &parent_translation, const G4RotationMatrix &parent_rotation, const bool dump_everything = false) {
+// sensitive elements are indexed by the same IDs the simulation writes, so the index answers
+// queries in terms of DET_ID without Geant4
+int detector_id(const std::string &name, const std::vector<G4int> &copy_numbers) {
+  const auto depth = copy_numbers.size();
+  if (is_strip_volume(name) && depth >= 4) {
+    return MATHUSLA::MU::Prototype::Table::StripID(copy_numbers[depth - 4], copy_numbers[depth - 2], copy_numbers[depth - 1]);
+  }
+  return MATHUSLA::MU::Prototype::Table::EncodeDetector(name);
+}
+
+void dump_volume(const G4VPhysicalVolume &physical_volume, const G4ThreeVector &parent_translation, const G4RotationMatrix &parent_rotation, std::vector<G4int> &copy_numbers, std::vector<MATHUSLA::util::spatial::element> &elements, const bool dump_everything = false) {
   const auto &logical_volume = *(physical_volume.GetLogicalVolume());
   const auto n_daughters = logical_volume.GetNoDaughters();
 
-  const auto name = logical_volume.GetName();
+  const auto is_strip = is_strip_volume(logical_volume.GetName());
+  const auto name = volume_name(logical_volume, copy_numbers);
 
   const auto translation = parent_translation + parent_rotation * physical_volume.GetTranslation();
 
@@ -54,7 +74,27 @@ void dump_volume(const G4VPhysicalVolume &physical_volume, const G4ThreeVector &
     rotation = rotation * relative_rotation_ptr->inverse();
   }
 
-  if (dump_everything || (n_daughters == 0 && (is_scintillator_name(name) || is_strip_name(name)))) {
+  if (n_daughters == 0 && (is_scintillator_name(name) || is_strip)) {
+    MATHUSLA::util::spatial::element element;
+    element.id = detector_id(logical_volume.GetName(), copy_numbers);
+    element.centre = to_point(translation);
+    element.axes = {{to_point(rotation.colX()), to_point(rotation.colY()), to_point(rotation.colZ())}};
+    if (is_strip) {
+      const auto &box = *static_cast<const G4Box *>(logical_volume.GetSolid());
+      element.half_x_low = element.half_x_high = box.GetXHalfLength();
+      element.half_y = box.GetYHalfLength();
+      element.half_z = box.GetZHalfLength();
+    } else {
+      const auto &trap = *static_cast<const G4Trap *>(logical_volume.GetSolid());
+      element.half_x_low = trap.GetXHalfLength1();
+      element.half_x_high = trap.GetXHalfLength3();
+      element.half_y = trap.GetYHalfLength1();
+      element.half_z = trap.GetZHalfLength();
+    }
+    elements.push_back(element);
+  }
+
+  if (dump_everything || (n_daughters == 0 && (is_scintillator_name(name) || is_strip))) {
     std::cout << name;
     std::cout.setf(std::ios::fixed);
     std::cout.precision(2);
@@ -72,7 +112,7 @@ void dump_volume(const G4VPhysicalVolume &physical_volume, const G4ThreeVector &
       std::cout << "," << 2.0 * trap.GetYHalfLength1();
       std::cout << "," << 2.0 * trap.GetYHalfLength2();
       std::cout << "," << 2.0 * trap.GetZHalfLength();
-    } else if (is_strip_name(name)) {
+    } else if (is_strip) {
       const auto &box = *static_cast<const G4Box *>(logical_volume.GetSolid());
       std::cout << "," << 2.0 * box.GetXHalfLength();
       std::cout << "," << 2.0 * box.GetYHalfLength();
@@ -81,22 +121,50 @@ void dump_volume(const G4VPhysicalVolume &physical_volume, const G4ThreeVector &
     std::cout << std::endl;
   }
   for (G4int daughter_index = 0; daughter_index < n_daughters; daughter_index++) {
-    const auto &daughter_volume = *(logical_volume.GetDaughter(daughter_index));
-    dump_volume(daughter_volume, translation, rotation, dump_everything);
+    auto &daughter_volume = *(logical_volume.GetDaughter(daughter_index));
+    if (!daughter_volume.IsReplicated()) {
+      copy_numbers.push_back(daughter_volume.GetCopyNo());
+      dump_volume(daughter_volume, translation, rotation, copy_numbers, elements, dump_everything);
+      copy_numbers.pop_back();
+      continue;
+    }
+    EAxis axis;
+    G4int n_copies;
+    G4double width, offset;
+    G4bool consuming;
+    daughter_volume.GetReplicationData(axis, n_copies, width, offset, consuming);
+    const auto *const parameterisation = daughter_volume.GetParameterisation();
+    for (G4int copy = 0; copy < n_copies; copy++) {
+      if (parameterisation != nullptr) {
+        parameterisation->ComputeTransformation(copy, &daughter_volume);
+      } else {
+        G4ReplicaNavigation().ComputeTransformation(copy, &daughter_volume);
+      }
+      copy_numbers.push_back(copy);
+      dump_volume(daughter_volume, translation, rotation, copy_numbers, elements, dump_everything);
+      copy_numbers.pop_back();
+    }
   }
 }
 
-void dump_world(const G4VPhysicalVolume &physical_volume, const bool dump_everything = false) {
-  dump_volume(physical_volume, G4ThreeVector(0.0, 0.0, 0.0), G4RotationMatrix(0.0, 0.0, 0.0), dump_everything);
+void dump_world(const G4VPhysicalVolume &physical_volume, std::vector<MATHUSLA::util::spatial::element> &elements, const bool dump_everything = false) {
+  std::vector<G4int> copy_numbers{physical_volume.GetCopyNo()};
+  dump_volume(physical_volume, G4ThreeVector(0.0, 0.0, 0.0), G4RotationMatrix(0.0, 0.0, 0.0), copy_numbers, elements, dump_everything);
 }
 
 int main(const int argc, const char *const argv[]) {
   bool dump_everything = false;
-  if (argc == 2 && std::string(argv[1]) == "all") {
-    dump_everything = true;
-  } else if (argc != 1) {
-    std::cout << "Usage: " << argv[0] << " [all]" << std::endl;
-    return 1;
+  std::string index_path = "test-stand-geometry-index.bin";
+  for (int i = 1; i < argc; i++) {
+    const std::string argument = argv[i];
+    if (argument == "all") {
+      dump_everything = true;
+    } else if (argument == "--index" && i + 1 < argc) {
+      index_path = argv[++i];
+    } else {
+      std::cout << "Usage: " << argv[0] << " [all] [--index <file>]" << std::endl;
+      return 1;
+    }
   }
   MATHUSLA::MU::Construction::Builder test_stand_builder("Prototype", "test-stand-geometry-dump", true);
   const auto &world = *(test_stand_builder.Construct());
@@ -113,6 +181,12 @@ int main(const int argc, const char *const argv[]) {
   std::cout << "# Global azimuthal angle of local z-axis of volume (rad)" << std::endl;
   std::cout << "# (Additional detector-specific fields for dimensions of scintillators and strips) " << std::endl;
   std::cout << std::endl;
-  dump_world(world, dump_everything);
+  std::vector<MATHUSLA::util::spatial::element> elements;
+  dump_world(world, elements, dump_everything);
+  const MATHUSLA::util::spatial::grid index(std::move(elements));
+  if (!index.write(index_path)) {
+    std::cerr << "Unable to write spatial index to " << index_path << std::endl;
+    return 1;
+  }
   return 0;
 }
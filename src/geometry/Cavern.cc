@@ -20,6 +20,10 @@
 #include <G4IntersectionSolid.hh>
 #include <G4UnionSolid.hh>
 #include <G4SubtractionSolid.hh>
+#include <G4ExtrudedSolid.hh>
+#include <G4TwoVector.hh>
+
+#include <algorithm>
 
 #include "geometry/Construction.hh"
 
@@ -29,6 +33,12 @@ namespace { ////////////////////////////////////////////////////////////////////
 
 //__Cavern Dimensions___________________________________________________________________________
 static auto _base_depth = Cavern::DefaultBaseDepth;
+constexpr auto _y_shift = 1.7L*m;
+//----------------------------------------------------------------------------------------------
+
+//__Number of Chords Approximating the Vault____________________________________________________
+// with 64 chords the vault is at most 2 mm inside the true cylinder
+constexpr auto _vault_segments = 64;
 //----------------------------------------------------------------------------------------------
 
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
@@ -139,11 +149,149 @@ G4LogicalVolume* _calculate_modification(const std::string& name,
   return Construction::Volume(new G4SubtractionSolid(name,
     earth_component->GetSolid(),
     Volume()->GetSolid(),
-    Construction::Transform(0, 1.7 * m, -0.5 * (base_depth - top_depth) + CenterDepth() - top_depth)),
+    Construction::Transform(0, _y_shift, -0.5 * (base_depth - top_depth) + CenterDepth() - top_depth)),
     earth_component->GetMaterial());
 }
 //----------------------------------------------------------------------------------------------
 
+//__Detector Ring Transformation at Depth_______________________________________________________
+const G4Transform3D _ring_transform(const long double z) {
+  return G4Translate3D(0, 0, z)
+    * Construction::Rotate(0.0, 1.0, 0.0, -P1ForwardTilt)
+    * Construction::Rotate(0, 1, 0, 90*deg);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Vertical Half Extent of Tilted Detector Ring________________________________________________
+long double _ring_extent() {
+  return DetectorRadius * cosP1Tilt() + 0.5L * DetectorLength * sinP1Tilt();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Cavern Cross Section in the y-z Plane_______________________________________________________
+// relative to the cavern center, with z pointing down like the earth depth
+std::vector<G4TwoVector> _cross_section() {
+  const auto half_width = 0.5L * CavernWidth;
+  const auto vault_center = VaultRadius - 0.5L * CavernHeight;
+  const auto vault_angle = std::asin(half_width / VaultRadius);
+  std::vector<G4TwoVector> out{G4TwoVector(-half_width, 0.5L * CavernHeight),
+                               G4TwoVector(half_width, 0.5L * CavernHeight)};
+  for (int i{}; i <= _vault_segments; ++i) {
+    const auto angle = vault_angle * (1.0L - 2.0L * i / _vault_segments);
+    out.emplace_back(VaultRadius * std::sin(angle), vault_center - VaultRadius * std::cos(angle));
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Clip Polygon to One Side of Horizontal Line_________________________________________________
+std::vector<G4TwoVector> _clip(const std::vector<G4TwoVector>& polygon,
+                               const double bound,
+                               const double sign) {
+  std::vector<G4TwoVector> out;
+  for (std::size_t i{}; i < polygon.size(); ++i) {
+    const auto& current = polygon[i];
+    const auto& next = polygon[(i + 1) % polygon.size()];
+    const auto current_inside = sign * (current.y() - bound) >= 0;
+    const auto next_inside = sign * (next.y() - bound) >= 0;
+    if (current_inside)
+      out.push_back(current);
+    if (current_inside != next_inside)
+      out.push_back(current + (next - current) * ((bound - current.y()) / (next.y() - current.y())));
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Remove Repeated and Collinear Vertices and Order Clockwise__________________________________
+std::vector<G4TwoVector> _simplify(std::vector<G4TwoVector> polygon) {
+  constexpr auto tolerance = 1.0*um;
+  for (std::size_t i{}; polygon.size() >= 3 && i < polygon.size();) {
+    const auto& previous = polygon[(i + polygon.size() - 1) % polygon.size()];
+    const auto& current = polygon[i];
+    const auto& next = polygon[(i + 1) % polygon.size()];
+    const auto in = current - previous;
+    const auto out = next - current;
+    if (in.mag() < tolerance || std::abs(in.x() * out.y() - in.y() * out.x()) < tolerance * (in.mag() + out.mag())) {
+      polygon.erase(polygon.begin() + i);
+      i = 0;
+    } else {
+      ++i;
+    }
+  }
+  double area{};
+  for (std::size_t i{}; i < polygon.size(); ++i) {
+    const auto& current = polygon[i];
+    const auto& next = polygon[(i + 1) % polygon.size()];
+    area += current.x() * next.y() - next.x() * current.y();
+  }
+  if (area > 0)
+    std::reverse(polygon.begin(), polygon.end());
+  return polygon;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Rotation from Extrusion Frame to Earth Frame________________________________________________
+// the cross section lies in the y-z plane and is extruded along x
+const G4Transform3D _extrusion_transform() {
+  return G4Transform3D(Construction::Matrix(0, 0, 1, 1, 0, 0, 0, 1, 0), G4ThreeVector());
+}
+//----------------------------------------------------------------------------------------------
+
+//__Place Part of Cavern Inside Earth Layer_____________________________________________________
+G4LogicalVolume* _place_cavern_piece(const Earth::Layer& layer) {
+  const auto top = std::max(layer.top, TopDepth());
+  const auto bottom = std::min(layer.bottom, BaseDepth());
+  if (bottom <= top)
+    return nullptr;
+
+  const auto center = CenterDepth();
+  auto polygon = _simplify(_clip(_clip(_cross_section(), top - center, 1), bottom - center, -1));
+  if (polygon.size() < 3)
+    return nullptr;
+
+  const auto layer_center = 0.5L * (layer.top + layer.bottom);
+  for (auto& vertex : polygon)
+    vertex.set(vertex.x() + _y_shift, vertex.y() + center - layer_center);
+
+  auto cavern = Construction::Volume(new G4ExtrudedSolid("Cavern",
+    polygon, 0.5L * CavernLength, G4TwoVector(), 1.0, G4TwoVector(), 1.0));
+  Construction::PlaceVolume(cavern, layer.volume, _extrusion_transform());
+  return cavern;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check Cavern Fits Decomposed Earth__________________________________________________________
+// the cavern must stay below the sandstone around the SX1 slab, and the detector ring must
+// lie inside a single layer so that it can be placed inside one piece of the cavern
+bool _fits_decomposed() {
+  const auto sandstone_frame = std::max(Earth::SX1SlabDepth(),
+                                        Earth::BufferZoneHigherDepth() + Earth::BufferZoneLowerDepth());
+  const auto ring_top = IP() - _ring_extent();
+  const auto ring_bottom = IP() + _ring_extent();
+  const auto marl_top = Earth::SandstoneDepth();
+  const auto mix_top = marl_top + Earth::MarlDepth();
+  return TopDepth() >= sandstone_frame
+      && ring_top >= TopDepth() && ring_bottom <= BaseDepth()
+      && !_between(ring_top, ring_bottom, marl_top)
+      && !_between(ring_top, ring_bottom, mix_top);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Construct Cavern as Air Volumes Inside Decomposed Earth_____________________________________
+void _construct_decomposed(G4LogicalVolume* earth) {
+  const auto ring_top = IP() - _ring_extent();
+  const auto ring_bottom = IP() + _ring_extent();
+  for (const auto& layer : Earth::PlaceDecomposedLayers(earth)) {
+    auto cavern = _place_cavern_piece(layer);
+    if (cavern && layer.top <= ring_top && ring_bottom <= layer.bottom) {
+      Construction::PlaceVolume(RingVolume(), cavern,
+        _extrusion_transform().inverse() * _ring_transform(IP() - 0.5L * (layer.top + layer.bottom)));
+    }
+  }
+}
+//----------------------------------------------------------------------------------------------
+
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 //__Construct Cavern____________________________________________________________________________
@@ -153,6 +301,14 @@ G4VPhysicalVolume* Construct(G4LogicalVolume* world) {
 
   auto earth = Earth::Volume();
 
+  if (Earth::Decomposed()) {
+    if (_fits_decomposed()) {
+      _construct_decomposed(earth);
+      return Construction::PlaceVolume(earth, world, Earth::Transform());
+    }
+    std::cout << "[WARNING] Cavern Does Not Fit Decomposed Earth Layers. Using Boolean Solids.\n";
+  }
+
   const auto mix_top = Earth::TotalDepth() - Earth::MixDepth();
   const auto marl_top = mix_top - Earth::MarlDepth();
   const auto sandstone_top = marl_top - Earth::SandstoneDepth();
@@ -196,10 +352,7 @@ G4VPhysicalVolume* Construct(G4LogicalVolume* world) {
 
   Construction::PlaceVolume(Earth::SX1SlabVolume(), earth, Earth::SX1SlabTransform());
 
-  Construction::PlaceVolume(RingVolume(), earth,
-    G4Translate3D(0, 0, -0.5 * Earth::TotalDepth() + IP())
-      * Construction::Rotate(0.0, 1.0, 0.0, -P1ForwardTilt)
-      * Construction::Rotate(0, 1, 0, 90*deg));
+  Construction::PlaceVolume(RingVolume(), earth, _ring_transform(IP() - 0.5L * Earth::TotalDepth()));
   return Construction::PlaceVolume(earth, world, Earth::Transform());
 }
 //----------------------------------------------------------------------------------------------
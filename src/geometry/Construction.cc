@@ -18,6 +18,9 @@
 #include "geometry/Construction.hh"
 
 #include <G4SubtractionSolid.hh>
+#include <G4BooleanSolid.hh>
+#include <G4DisplacedSolid.hh>
+#include <G4MultiUnion.hh>
 #include <G4GeometryManager.hh>
 #include <G4GeometryTolerance.hh>
 #include <G4LogicalVolumeStore.hh>
@@ -26,16 +29,46 @@
 #include <G4Colour.hh>
 #include <G4SolidStore.hh>
 #include <G4PVPlacement.hh>
+#include <G4PVParameterised.hh>
+#include <G4PVReplica.hh>
+#include <G4VPVParameterisation.hh>
 #include <G4NistManager.hh>
 #include <G4GDMLParser.hh>
+#include <G4RegionStore.hh>
+#include <G4ProductionCuts.hh>
+#include <G4UserLimits.hh>
+#include <G4UnitsTable.hh>
+#include <G4VisExtent.hh>
+#include <G4Navigator.hh>
+#include <G4TransportationManager.hh>
+#include <G4Threading.hh>
 #include <tls.hh>
 
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
 #include "geometry/Box.hh"
+#include "geometry/Cavern.hh"
+#include "geometry/Earth.hh"
 #include "geometry/Prototype.hh"
 #include "geometry/Flat.hh"
 #include "geometry/MuonMapper.hh"
 
+#include "physics/Builder.hh"
+#include "physics/MuonTransportModel.hh"
+
+#include "tracking.hh"
+
 #include "util/io.hh"
+#include "util/string.hh"
 
 namespace MATHUSLA { namespace MU {
 
@@ -55,10 +88,476 @@ const Analysis::ROOT::DataKeyTypeList* _data_key_types;
 bool _save_option;
 //----------------------------------------------------------------------------------------------
 
+//__Current Earth Placement_____________________________________________________________________
+G4VPhysicalVolume* _earth = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__Geometry Cache______________________________________________________________________________
+// the cache only replaces the geometry built at initialization, when no detector has
+// registered any volumes yet, so later rebuilds are always procedural
+std::string _geometry_cache;
+bool _cache_checked = false;
+bool _cache_pending = false;
+bool _from_cache = false;
+std::vector<std::pair<G4LogicalVolume*, std::string>> _cache_sensitive;
+//----------------------------------------------------------------------------------------------
+
+//__Earth Construction Modes____________________________________________________________________
+const std::string& _earth_modes = "boolean decomposed";
+//----------------------------------------------------------------------------------------------
+
 //__Detector List_______________________________________________________________________________
 const std::string& _detectors = "Prototype Flat Box MuonMapper";
 //----------------------------------------------------------------------------------------------
 
+//__Detector Envelope in World Coordinates_____________________________________________________
+G4ThreeVector _envelope_min;
+G4ThreeVector _envelope_max;
+//----------------------------------------------------------------------------------------------
+
+//__Compute Axis-Aligned Bounding Box of Placed Volume__________________________________________
+void _set_envelope(const G4VPhysicalVolume* volume) {
+  const auto extent = volume->GetLogicalVolume()->GetSolid()->GetExtent();
+  const auto rotation = volume->GetObjectRotationValue();
+  const auto translation = volume->GetObjectTranslation();
+  _envelope_min = G4ThreeVector(DBL_MAX, DBL_MAX, DBL_MAX);
+  _envelope_max = -_envelope_min;
+  for (const auto x : {extent.GetXmin(), extent.GetXmax()}) {
+    for (const auto y : {extent.GetYmin(), extent.GetYmax()}) {
+      for (const auto z : {extent.GetZmin(), extent.GetZmax()}) {
+        const auto corner = rotation * G4ThreeVector(x, y, z) + translation;
+        _envelope_min.set(std::min(_envelope_min.x(), corner.x()),
+                          std::min(_envelope_min.y(), corner.y()),
+                          std::min(_envelope_min.z(), corner.z()));
+        _envelope_max.set(std::max(_envelope_max.x(), corner.x()),
+                          std::max(_envelope_max.y(), corner.y()),
+                          std::max(_envelope_max.z(), corner.z()));
+      }
+    }
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Region List_________________________________________________________________________________
+const std::vector<std::string> _regions{"Earth", "Cavern", "Detector"};
+//----------------------------------------------------------------------------------------------
+
+//__Region Production Cuts and Maximum Step Lengths_____________________________________________
+// rock only needs secondaries energetic enough to escape into the cavern, step limits are off
+std::unordered_map<std::string, double> _region_cuts{
+  {"Earth", 1*cm}, {"Cavern", 1*mm}, {"Detector", 0.7*mm}};
+std::unordered_map<std::string, double> _region_steps{
+  {"Earth", 0}, {"Cavern", 0}, {"Detector", 0}};
+//----------------------------------------------------------------------------------------------
+
+//__Geant4 Region Name for Region Key___________________________________________________________
+const std::string _region_name(const std::string& key) {
+  return key == "Detector" ? _detector : key;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Update Region Cuts and Limits_______________________________________________________________
+void _update_region(const std::string& key) {
+  auto region = G4RegionStore::GetInstance()->GetRegion(_region_name(key), false);
+  if (!region)
+    return;
+
+  auto cuts = region->GetProductionCuts();
+  if (!cuts) {
+    cuts = new G4ProductionCuts;
+    region->SetProductionCuts(cuts);
+  }
+  cuts->SetProductionCut(_region_cuts[key]);
+  for (const auto& particle : Physics::Builder::GetParticleCuts())
+    cuts->SetProductionCut(particle.second, particle.first);
+
+  const auto step = _region_steps[key] > 0 ? _region_steps[key] : DBL_MAX;
+  auto limits = region->GetUserLimits();
+  if (limits) {
+    limits->SetMaxAllowedStep(step);
+  } else if (step != DBL_MAX) {
+    region->SetUserLimits(new G4UserLimits(step));
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Fast Muon Transport Model for Thread________________________________________________________
+G4ThreadLocal Physics::MuonTransportModel* _muon_transport = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__Names of Regions Created for the Geometry___________________________________________________
+std::set<std::string> _region_names;
+//----------------------------------------------------------------------------------------------
+
+//__Attach Volume to Region_____________________________________________________________________
+void _set_region(const std::string& key,
+                 G4LogicalVolume* volume) {
+  if (!volume)
+    return;
+  const auto name = _region_name(key);
+  G4RegionStore::GetInstance()->FindOrCreateRegion(name)->AddRootLogicalVolume(volume);
+  _region_names.insert(name);
+  _update_region(key);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Detach Root Volumes from Regions____________________________________________________________
+// the volume store locks its volumes before deleting them, so they never remove themselves from
+// their regions and the next initialization would walk freed volumes
+void _detach_regions() {
+  for (const auto& name : _region_names) {
+    const auto region = G4RegionStore::GetInstance()->GetRegion(name, false);
+    if (!region)
+      continue;
+    std::vector<G4LogicalVolume*> roots;
+    roots.reserve(region->GetNumberOfRootVolumes());
+    auto root = region->GetRootLogicalVolumeIterator();
+    for (std::size_t i{}; i < region->GetNumberOfRootVolumes(); ++i, ++root)
+      roots.push_back(*root);
+    for (const auto volume : roots)
+      region->RemoveRootLogicalVolume(volume, false);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Clean Geometry Stores_______________________________________________________________________
+void _clean_stores() {
+  G4GeometryManager::GetInstance()->OpenGeometry();
+  _detach_regions();
+  G4PhysicalVolumeStore::GetInstance()->Clean();
+  G4LogicalVolumeStore::GetInstance()->Clean();
+  G4SolidStore::GetInstance()->Clean();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Geometry Cache Format Version_______________________________________________________________
+// the build hashes the geometry sources into the key, the version only needs a bump when the
+// geometry changes through code outside include/geometry and src/geometry
+constexpr auto _geometry_version = 1;
+#ifdef MU__GEOMETRY_SOURCE_HASH
+constexpr auto _geometry_sources = MU__GEOMETRY_SOURCE_HASH;
+#else
+constexpr auto _geometry_sources = "";
+#endif
+//----------------------------------------------------------------------------------------------
+
+//__Hash of Geometry Parameters_________________________________________________________________
+const std::string _geometry_hash() {
+  std::ostringstream parameters;
+  parameters.precision(17);
+  parameters << _geometry_version << ' ' << _geometry_sources << ' ' << _detector << ' ' << Earth::Decomposed();
+  for (const auto value : {Earth::LastShift(),
+                           Earth::LayerWidthX(),
+                           Earth::LayerWidthY(),
+                           Earth::BufferZoneShiftX(),
+                           Earth::BufferZoneLength(),
+                           Earth::BufferZoneHigherWidth(),
+                           Earth::BufferZoneLowerWidth(),
+                           Earth::BufferZoneHigherDepth(),
+                           Earth::BufferZoneLowerDepth(),
+                           Earth::SX1SlabWidth(),
+                           Earth::SX1SlabDepth(),
+                           Earth::SandstoneDepth(),
+                           Earth::MarlDepth(),
+                           Earth::MixDepth()}) {
+    parameters << ' ' << static_cast<double>(value / mm);
+  }
+
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (const auto c : parameters.str()) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+
+  std::ostringstream out;
+  out << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return out.str();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Share Materials with Procedural Construction________________________________________________
+// the cache names every material with its pointer suffix, so materials which are already defined
+// are dropped from the text and their references renamed, and the parser reuses the defined ones
+// instead of adding a second copy
+const std::string _share_materials(std::string contents) {
+  Earth::Material::Define();
+  const std::string open_tag = "<material ", close_tag = "</material>", name_key = "name=\"";
+  for (auto begin = contents.find(open_tag); begin != std::string::npos;) {
+    const auto end = contents.find(close_tag, begin);
+    const auto name_begin = contents.find(name_key, begin);
+    if (end == std::string::npos || name_begin == std::string::npos || name_begin > end)
+      break;
+    const auto name_start = name_begin + name_key.size();
+    const auto name = contents.substr(name_start, contents.find('"', name_start) - name_start);
+    const auto defined = name.substr(0, name.rfind("0x"));
+    if (defined == name || !G4Material::GetMaterial(defined, false)) {
+      begin = contents.find(open_tag, end);
+      continue;
+    }
+
+    contents.erase(begin, end + close_tag.size() - begin);
+    const auto reference = "ref=\"" + name + "\"";
+    const auto replacement = "ref=\"" + defined + "\"";
+    for (auto at = contents.find(reference); at != std::string::npos;
+         at = contents.find(reference, at + replacement.size()))
+      contents.replace(at, reference.size(), replacement);
+    begin = contents.find(open_tag, begin);
+  }
+  return contents;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Load World from Geometry Cache______________________________________________________________
+// the hash is found by scanning the file so stale caches are never parsed into the stores
+G4VPhysicalVolume* _load_cache(const std::string& path,
+                               const std::string& hash) {
+  std::ifstream file(path);
+  if (!file)
+    return nullptr;
+  const std::string contents{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  if (contents.find("auxvalue=\"" + hash + "\"") == std::string::npos) {
+    std::cout << "Geometry Cache \"" << path << "\" is Stale. Rebuilding Geometry.\n";
+    return nullptr;
+  }
+
+  const auto shared_path = path + ".shared";
+  std::ofstream(shared_path) << _share_materials(contents);
+  G4GDMLParser parser;
+  parser.Read(shared_path, false);
+  util::io::remove_file(shared_path);
+  const auto world = parser.GetWorldVolume();
+
+  bool matched = false;
+  std::unordered_map<std::string, G4LogicalVolume*> regions;
+  _cache_sensitive.clear();
+  for (const auto& entry : *parser.GetAuxMap()) {
+    for (const auto& aux : entry.second) {
+      if (aux.type == "GeometryHash") {
+        matched = world && entry.first == world->GetLogicalVolume() && aux.value == hash;
+      } else if (aux.type == "SensDet") {
+        _cache_sensitive.emplace_back(entry.first, aux.value);
+      } else if (aux.type == "Region") {
+        regions[aux.value] = entry.first;
+      }
+    }
+  }
+
+  if (!matched) {
+    std::cout << "[WARNING] Geometry Cache \"" << path << "\" has no Matching Hash. Rebuilding Geometry.\n";
+    _cache_sensitive.clear();
+    _clean_stores();
+    return nullptr;
+  }
+
+  for (const auto& region : _regions)
+    _set_region(region, regions[region]);
+
+  const auto world_volume = world->GetLogicalVolume();
+  for (std::size_t i{}; i < world_volume->GetNoDaughters(); ++i) {
+    const auto daughter = world_volume->GetDaughter(i);
+    if (daughter->GetLogicalVolume() == regions["Earth"]) {
+      _earth = daughter;
+    } else if (daughter->GetLogicalVolume() == regions["Detector"]) {
+      _set_envelope(daughter);
+    }
+  }
+
+  std::cout << "Loaded Geometry Cache \"" << path << "\" (" << hash << ", "
+            << G4Material::GetNumberOfMaterials() << " Materials)\n";
+  return world;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write World to Geometry Cache_______________________________________________________________
+// sensitive detectors and regions are stored as auxiliary tags on their logical volumes, the
+// detector IDs come from copy numbers which GDML keeps
+void _write_cache(const std::string& path,
+                  const std::string& hash) {
+  const auto world = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
+  if (!world)
+    return;
+
+  G4GDMLParser parser;
+  parser.AddVolumeAuxiliary({"GeometryHash", hash, "", nullptr}, world->GetLogicalVolume());
+  for (const auto volume : *G4LogicalVolumeStore::GetInstance()) {
+    const auto detector = volume->GetSensitiveDetector();
+    if (detector)
+      parser.AddVolumeAuxiliary({"SensDet", detector->GetFullPathName(), "", nullptr}, volume);
+  }
+  for (const auto& key : _regions) {
+    const auto region = G4RegionStore::GetInstance()->GetRegion(_region_name(key), false);
+    if (!region)
+      continue;
+    auto root = region->GetRootLogicalVolumeIterator();
+    for (std::size_t i{}; i < region->GetNumberOfRootVolumes(); ++i, ++root)
+      parser.AddVolumeAuxiliary({"Region", key, "", nullptr}, *root);
+  }
+
+  if (util::io::path_exists(path))
+    util::io::remove_file(path);
+  parser.Write(path, world, true, G4GDML_DEFAULT_SCHEMALOCATION);
+  std::cout << "Wrote Geometry Cache \"" << path << "\" (" << hash << ", "
+            << G4Material::GetNumberOfMaterials() << " Materials)\n";
+}
+//----------------------------------------------------------------------------------------------
+
+//__Construct Earth for Current Detector________________________________________________________
+G4VPhysicalVolume* _construct_earth(G4LogicalVolume* world) {
+  if (_detector == "Flat") {
+    return Flat::Detector::ConstructEarth(world);
+  } else if (_detector == "Box") {
+    return Box::Detector::ConstructEarth(world);
+  } else if (_detector == "MuonMapper") {
+    return MuonMapper::Detector::ConstructEarth(world);
+  }
+  return Prototype::Detector::ConstructEarth(world);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Earth Mass per Material_____________________________________________________________________
+using MassBudget = std::map<std::string, double>;
+double _cubic_volume(G4VSolid* solid,
+                     const std::size_t points) {
+  // boolean solids only have a Monte Carlo estimate of their volume
+  auto boolean = dynamic_cast<G4BooleanSolid*>(solid);
+  if (boolean)
+    boolean->SetCubVolStatistics(points);
+  return solid->GetCubicVolume();
+}
+void _add_mass(const G4LogicalVolume* volume,
+               const std::size_t points,
+               MassBudget& budget) {
+  auto own = _cubic_volume(volume->GetSolid(), points);
+  for (std::size_t i{}; i < volume->GetNoDaughters(); ++i) {
+    const auto daughter = volume->GetDaughter(i)->GetLogicalVolume();
+    own -= _cubic_volume(daughter->GetSolid(), points);
+    _add_mass(daughter, points, budget);
+  }
+  const auto material = volume->GetMaterial();
+  budget[material->GetName()] += own * material->GetDensity();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Count Overlapping Placements Below Volume___________________________________________________
+std::size_t _count_overlaps(const G4LogicalVolume* volume) {
+  std::size_t out{};
+  for (std::size_t i{}; i < volume->GetNoDaughters(); ++i) {
+    const auto daughter = volume->GetDaughter(i);
+    out += daughter->CheckOverlaps(1000, 0, false);
+    out += _count_overlaps(daughter->GetLogicalVolume());
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Delete Unused Volume Tree___________________________________________________________________
+// solids are collected through their boolean and multi-union constituents, and a solid which an
+// earlier deletion already removed from the store, like a boolean's own displaced solid, is skipped
+void _collect_solids(G4VSolid* solid,
+                     std::vector<G4VSolid*>& solids) {
+  if (!solid || std::find(solids.cbegin(), solids.cend(), solid) != solids.cend())
+    return;
+  solids.push_back(solid);
+  if (const auto boolean = dynamic_cast<G4BooleanSolid*>(solid)) {
+    _collect_solids(boolean->GetConstituentSolid(0), solids);
+    _collect_solids(boolean->GetConstituentSolid(1), solids);
+  } else if (const auto displaced = dynamic_cast<G4DisplacedSolid*>(solid)) {
+    _collect_solids(displaced->GetConstituentMovedSolid(), solids);
+  } else if (const auto multi_union = dynamic_cast<G4MultiUnion*>(solid)) {
+    for (int i{}; i < multi_union->GetNumberOfSolids(); ++i)
+      _collect_solids(multi_union->GetSolid(i), solids);
+  }
+}
+void _collect_tree(G4VPhysicalVolume* volume,
+                   std::vector<G4VPhysicalVolume*>& physical,
+                   std::vector<G4LogicalVolume*>& logical,
+                   std::vector<G4VSolid*>& solids) {
+  physical.push_back(volume);
+  const auto current = volume->GetLogicalVolume();
+  if (std::find(logical.cbegin(), logical.cend(), current) != logical.cend())
+    return;
+  logical.push_back(current);
+  _collect_solids(current->GetSolid(), solids);
+  for (std::size_t i{}; i < current->GetNoDaughters(); ++i)
+    _collect_tree(current->GetDaughter(i), physical, logical, solids);
+}
+void _delete_tree(G4VPhysicalVolume* volume) {
+  std::vector<G4VPhysicalVolume*> physical;
+  std::vector<G4LogicalVolume*> logical;
+  std::vector<G4VSolid*> solids;
+  _collect_tree(volume, physical, logical, solids);
+  for (auto placement : physical)
+    delete placement;
+  for (auto current : logical)
+    delete current;
+  const auto store = G4SolidStore::GetInstance();
+  for (auto solid : solids)
+    if (std::find(store->cbegin(), store->cend(), solid) != store->cend())
+      delete solid;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Box Region in Earth Coordinates_____________________________________________________________
+// depths are measured downward from the top of the earth
+struct SampleRegion {
+  std::string name;
+  G4ThreeVector min, max;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Regions Where the Earth Construction Modes Differ___________________________________________
+std::vector<SampleRegion> _sample_regions() {
+  const auto margin = 1*m;
+  const auto slab_x = 0.5 * Earth::BufferZoneLength() + margin;
+  const auto slab_y = 0.5 * Earth::SX1SlabWidth() + margin;
+  std::vector<SampleRegion> out{
+    {"SX1 Slab", G4ThreeVector(Earth::BufferZoneShiftX() - slab_x, -slab_y, 0),
+                 G4ThreeVector(Earth::BufferZoneShiftX() + slab_x, slab_y, Earth::SX1SlabDepth() + margin)}};
+  if (_detector == "Prototype") {
+    const auto cavern_x = 0.5 * Cavern::CavernLength + margin;
+    const auto cavern_y = 0.5 * Cavern::CavernWidth + margin;
+    out.push_back({"Cavern", G4ThreeVector(-cavern_x, 1.7*m - cavern_y, Cavern::TopDepth() - margin),
+                             G4ThreeVector(cavern_x, 1.7*m + cavern_y, Cavern::BaseDepth() + margin)});
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Earth Material Name at Point________________________________________________________________
+// points outside of the earth are skipped since only one of the worlds contains the detector
+const std::string _material_at(G4Navigator& navigator,
+                               const G4VPhysicalVolume* earth,
+                               const G4ThreeVector& point) {
+  if (earth->GetLogicalVolume()->GetSolid()->Inside(point - earth->GetTranslation()) == kOutside)
+    return "";
+  const auto volume = navigator.LocateGlobalPointAndSetup(point, nullptr, false, true);
+  return volume ? volume->GetLogicalVolume()->GetMaterial()->GetName() : "";
+}
+//----------------------------------------------------------------------------------------------
+
+//__Parameterisation over Fixed Placements______________________________________________________
+class TransformParameterisation : public G4VPVParameterisation {
+public:
+  TransformParameterisation(const std::vector<G4Transform3D>& transforms) {
+    for (const auto& transform : transforms) {
+      const auto rotation = transform.getRotation();
+      _translations.push_back(transform.getTranslation());
+      _rotations.push_back(rotation.isIdentity() ? nullptr : new G4RotationMatrix(rotation.inverse()));
+    }
+  }
+
+  void ComputeTransformation(const G4int copy,
+                             G4VPhysicalVolume* volume) const {
+    volume->SetTranslation(_translations[copy]);
+    volume->SetRotation(_rotations[copy]);
+  }
+
+private:
+  std::vector<G4ThreeVector> _translations;
+  std::vector<G4RotationMatrix*> _rotations;
+};
+//----------------------------------------------------------------------------------------------
+
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 namespace Construction { ///////////////////////////////////////////////////////////////////////
@@ -91,11 +590,13 @@ const std::string Builder::MessengerDirectory = "/det/";
 //__Builder Constructor_________________________________________________________________________
 Builder::Builder(const std::string& detector,
                  const std::string& export_dir,
-                 const bool save_option)
+                 const bool save_option,
+                 const std::string& geometry_cache)
     : G4VUserDetectorConstruction(), G4UImessenger(MessengerDirectory, "Particle Detectors.") {
   _detector = detector;
   _export_dir = export_dir;
   _save_option = save_option;
+  _geometry_cache = geometry_cache;
 
   _select = CreateCommand<Command::StringArg>("select", "Select Detector.");
   _select->SetParameterName("detector", false);
@@ -108,67 +609,146 @@ Builder::Builder(const std::string& detector,
 
   _current = CreateCommand<Command::NoArg>("current", "Current Detector.");
   _current->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _region_list = CreateCommand<Command::NoArg>("region/list", "List Region Cuts and Step Limits.");
+  _region_list->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  for (const auto& region : _regions) {
+    const auto directory = "region/" + util::string::tolower(region) + "/";
+
+    auto cut = CreateCommand<Command::DoubleUnitArg>(directory + "cut", "Set " + region + " Production Cut.");
+    cut->SetParameterName("cut", false, false);
+    cut->SetRange("cut > 0");
+    cut->SetDefaultUnit("mm");
+    cut->SetUnitCandidates("um mm cm m");
+    cut->AvailableForStates(G4State_PreInit, G4State_Idle);
+    _region_cut.push_back(cut);
+
+    auto step = CreateCommand<Command::DoubleUnitArg>(directory + "step", "Set " + region + " Maximum Step (0 for None).");
+    step->SetParameterName("step", false, false);
+    step->SetRange("step >= 0");
+    step->SetDefaultUnit("m");
+    step->SetUnitCandidates("um mm cm m km");
+    step->AvailableForStates(G4State_PreInit, G4State_Idle);
+    _region_step.push_back(step);
+  }
+
+  _earth_mode = CreateCommand<Command::StringArg>("earth/mode", "Select Earth Construction Mode.");
+  _earth_mode->SetParameterName("mode", false);
+  _earth_mode->SetDefaultValue("boolean");
+  _earth_mode->SetCandidates(_earth_modes.c_str());
+  _earth_mode->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _earth_check = CreateCommand<Command::IntegerArg>("earth/check",
+    "Compare Earth Construction Modes and Check for Overlaps.");
+  _earth_check->SetParameterName("points", true);
+  _earth_check->SetDefaultValue(1000000);
+  _earth_check->SetRange("points > 0");
+  _earth_check->AvailableForStates(G4State_Idle);
+
+  _trigger_enable = CreateCommand<Command::BoolArg>("trigger/enable", "Discard Events which do not Trigger.");
+  _trigger_enable->SetParameterName("enable", false);
+  _trigger_enable->SetDefaultValue(false);
+  _trigger_enable->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _trigger_layer = CreateCommand<Command::StringArg>("trigger/layer", "Add Trigger Layer as Range of Detector IDs.");
+  _trigger_layer->SetParameterName("first last", false);
+  _trigger_layer->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _trigger_mask = CreateCommand<Command::StringArg>("trigger/mask", "Add Mask of Trigger Layers which must All Fire.");
+  _trigger_mask->SetParameterName("layers", false);
+  _trigger_mask->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _trigger_clear = CreateCommand<Command::NoArg>("trigger/clear", "Clear Trigger Layers and Masks.");
+  _trigger_clear->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _trigger_require = CreateCommand<Command::IntegerArg>("trigger/require", "Set Number of Layers Required to Trigger.");
+  _trigger_require->SetParameterName("layers", false);
+  _trigger_require->SetDefaultValue(1);
+  _trigger_require->SetRange("layers > 0");
+  _trigger_require->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _trigger_window = CreateCommand<Command::DoubleUnitArg>("trigger/window", "Set Trigger Time Window (0 for None).");
+  _trigger_window->SetParameterName("window", false, false);
+  _trigger_window->SetRange("window >= 0");
+  _trigger_window->SetDefaultUnit("ns");
+  _trigger_window->SetUnitCandidates("ps ns us ms s");
+  _trigger_window->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _trigger_threshold = CreateCommand<Command::DoubleUnitArg>("trigger/threshold", "Set Trigger Deposit Threshold per Element.");
+  _trigger_threshold->SetParameterName("threshold", false, false);
+  _trigger_threshold->SetRange("threshold >= 0");
+  _trigger_threshold->SetDefaultUnit("MeV");
+  _trigger_threshold->SetUnitCandidates("eV keV MeV GeV");
+  _trigger_threshold->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _trigger_print = CreateCommand<Command::NoArg>("trigger/print", "Print Trigger Settings.");
+  _trigger_print->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _truth = CreateCommand<Command::StringArg>("truth", "Select Generator Truth Level.");
+  _truth->SetParameterName("level", false);
+  _truth->SetDefaultValue("primaries");
+  _truth->SetCandidates(Tracking::TruthLevelNames().c_str());
+  _truth->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Build World and Detector Geometry___________________________________________________________
 G4VPhysicalVolume* Builder::Construct() {
-  G4GeometryManager::GetInstance()->OpenGeometry();
-  G4PhysicalVolumeStore::GetInstance()->Clean();
-  G4LogicalVolumeStore::GetInstance()->Clean();
-  G4SolidStore::GetInstance()->Clean();
+  _clean_stores();
 
   G4GeometryManager::GetInstance()->SetWorldMaximumExtent(WorldLength);
 
   std::cout << "Computed tolerance = "
             << G4GeometryTolerance::GetInstance()->GetSurfaceTolerance() / m << " m\n";
 
+  _from_cache = false;
+  if (!_geometry_cache.empty() && !_cache_checked) {
+    _cache_checked = true;
+    const auto world = _load_cache(_geometry_cache, _geometry_hash());
+    if (world) {
+      _from_cache = true;
+      Builder::SetSaveOption(_save_option);
+      return world;
+    }
+    _cache_pending = true;
+  }
+
   auto worldLV = BoxVolume("World", WorldLength, WorldLength, WorldLength - 700*m);
 
-  if (!_export_dir.empty()) {
-    if (_detector == "Flat") {
-      Export(Flat::Detector::Construct(worldLV), _export_dir, "flat.gdml");
-      Export(Flat::Detector::ConstructEarth(worldLV), _export_dir, "flat.earth.gdml");
-    } else if (_detector == "Box") {
-      Export(Box::Detector::Construct(worldLV), _export_dir, "box.gdml");
-      Export(Box::Detector::ConstructEarth(worldLV), _export_dir, "box.earth.gdml");
-    } else if (_detector == "MuonMapper") {
-      Export(MuonMapper::Detector::Construct(worldLV), _export_dir, "muon_mapper.gdml");
-      Export(MuonMapper::Detector::ConstructEarth(worldLV), _export_dir, "muon_mapper.earth.gdml");
-    } else {
-      Export(Prototype::Detector::Construct(worldLV), _export_dir, "prototype.gdml");
-      Export(Prototype::Detector::ConstructEarth(worldLV), _export_dir, "prototype.earth.gdml");
-    }
+  G4VPhysicalVolume* detector;
+  std::string export_name;
+  if (_detector == "Flat") {
+    detector = Flat::Detector::Construct(worldLV);
+    export_name = "flat";
+  } else if (_detector == "Box") {
+    detector = Box::Detector::Construct(worldLV);
+    export_name = "box";
+  } else if (_detector == "MuonMapper") {
+    detector = MuonMapper::Detector::Construct(worldLV);
+    export_name = "muon_mapper";
   } else {
-    if (_detector == "Flat") {
-      Flat::Detector::Construct(worldLV);
-      Flat::Detector::ConstructEarth(worldLV);
-    } else if (_detector == "Box") {
-      Box::Detector::Construct(worldLV);
-      Box::Detector::ConstructEarth(worldLV);
-    } else if (_detector == "MuonMapper") {
-      MuonMapper::Detector::Construct(worldLV);
-      MuonMapper::Detector::ConstructEarth(worldLV);
-    } else {
-      Prototype::Detector::Construct(worldLV);
-      Prototype::Detector::ConstructEarth(worldLV);
-    }
+    detector = Prototype::Detector::Construct(worldLV);
+    export_name = "prototype";
+  }
+  auto earth = _construct_earth(worldLV);
+  _earth = earth;
+
+  if (!_export_dir.empty()) {
+    Export(detector, _export_dir, export_name + ".gdml");
+    Export(earth, _export_dir, export_name + ".earth.gdml");
   }
 
   Builder::SetSaveOption(_save_option);
 
+  _set_region("Earth", earth->GetLogicalVolume());
+  _set_region("Cavern", G4LogicalVolumeStore::GetInstance()->GetVolume("DetectorRing", false));
+  _set_region("Detector", detector->GetLogicalVolume());
+  _set_envelope(detector);
+
   auto world = PlaceVolume(worldLV, nullptr);
-  if (!_export_dir.empty()) {
-    if (_detector == "Flat") {
-      Export(world, _export_dir, "world.flat.gdml");
-    } else if (_detector == "Box") {
-      Export(world, _export_dir, "world.box.gdml");
-    } else if (_detector == "MuonMapper") {
-      Export(world, _export_dir, "world.muon_mapper.gdml");
-    } else {
-      Export(world, _export_dir, "world.prototype.gdml");
-    }
-  }
+  if (!_export_dir.empty())
+    Export(world, _export_dir, "world." + export_name + ".gdml");
 
   std::cout << "Materials: "
             << *G4Material::GetMaterialTable() << '\n';
@@ -179,30 +759,48 @@ G4VPhysicalVolume* Builder::Construct() {
 
 //__Build Detector______________________________________________________________________________
 void Builder::ConstructSDandField() {
+  G4VSensitiveDetector* detector;
   if (_detector == "Flat") {
     _data_per_event = Flat::Detector::DataPerEvent;
     _data_name = Flat::Detector::DataName;
     _data_keys = &Flat::Detector::DataKeys;
     _data_key_types = &Flat::Detector::DataKeyTypes;
-    G4SDManager::GetSDMpointer()->AddNewDetector(new Flat::Detector);
+    detector = new Flat::Detector;
   } else if (_detector == "Box") {
     _data_per_event = Box::Detector::DataPerEvent;
     _data_name = Box::Detector::DataName;
     _data_keys = &Box::Detector::DataKeys;
     _data_key_types = &Box::Detector::DataKeyTypes;
-    G4SDManager::GetSDMpointer()->AddNewDetector(new Box::Detector);
+    detector = new Box::Detector;
   } else if (_detector == "MuonMapper") {
     _data_per_event = MuonMapper::Detector::DataPerEvent;
     _data_name = MuonMapper::Detector::DataName;
     _data_keys = &MuonMapper::Detector::DataKeys;
     _data_key_types = &MuonMapper::Detector::DataKeyTypes;
-    G4SDManager::GetSDMpointer()->AddNewDetector(new MuonMapper::Detector);
+    detector = new MuonMapper::Detector;
   } else {
     _data_per_event = Prototype::Detector::DataPerEvent;
     _data_name = Prototype::Detector::DataName;
     _data_keys = &Prototype::Detector::DataKeys;
     _data_key_types = &Prototype::Detector::DataKeyTypes;
-    G4SDManager::GetSDMpointer()->AddNewDetector(new Prototype::Detector);
+    detector = new Prototype::Detector;
+  }
+  G4SDManager::GetSDMpointer()->AddNewDetector(detector);
+
+  if (_from_cache) {
+    for (const auto& entry : _cache_sensitive)
+      if (entry.second == detector->GetFullPathName())
+        entry.first->SetSensitiveDetector(detector);
+  } else if (_cache_pending && G4Threading::IsMasterThread()) {
+    _cache_pending = false;
+    _write_cache(_geometry_cache, _geometry_hash());
+  }
+
+  // the Earth region outlives geometry rebuilds, so the model is only attached once per thread
+  if (!_muon_transport) {
+    const auto earth = G4RegionStore::GetInstance()->GetRegion("Earth", false);
+    if (earth)
+      _muon_transport = new Physics::MuonTransportModel(earth);
   }
 }
 //----------------------------------------------------------------------------------------------
@@ -215,6 +813,68 @@ void Builder::SetNewValue(G4UIcommand* command, G4String value) {
     std::cout << "Detectors: " << _detectors << "\n";
   } else if (command == _current) {
     std::cout << "Current Detector: " << _detector << "\n";
+  } else if (command == _region_list) {
+    std::cout << "Regions:\n";
+    for (const auto& region : _regions) {
+      std::cout << "  " << region << " (" << _region_name(region) << "): cut "
+                << G4BestUnit(_region_cuts[region], "Length") << ", max step ";
+      if (_region_steps[region] > 0)
+        std::cout << G4BestUnit(_region_steps[region], "Length") << "\n";
+      else
+        std::cout << "none\n";
+    }
+    const auto& particle_cuts = Physics::Builder::GetParticleCuts();
+    if (!particle_cuts.empty()) {
+      std::cout << "  Overridden by Physics Cuts \"" << Physics::Builder::GetCutProfile() << "\" for";
+      for (const auto& particle : particle_cuts)
+        std::cout << " " << particle.first << " (" << G4BestUnit(particle.second, "Length") << ")";
+      std::cout << "\n";
+    }
+  } else if (command == _earth_mode) {
+    SetEarthMode(value);
+  } else if (command == _earth_check) {
+    CheckEarth(_earth_check->GetNewIntValue(value));
+  } else if (command == _trigger_enable) {
+    Tracking::Trigger::Enable(_trigger_enable->GetNewBoolValue(value));
+  } else if (command == _trigger_layer) {
+    std::istringstream stream(value);
+    long first, last;
+    if (stream >> first >> last) {
+      Tracking::Trigger::AddLayer(first, last);
+    } else {
+      std::cout << "[WARNING] Expected \"<first> <last>\" for Trigger Layer.\n";
+    }
+  } else if (command == _trigger_mask) {
+    std::istringstream stream(value);
+    std::vector<std::size_t> layers;
+    std::size_t layer;
+    while (stream >> layer)
+      layers.push_back(layer);
+    if (stream.eof() && !layers.empty()) {
+      Tracking::Trigger::AddMask(layers);
+    } else {
+      std::cout << "[WARNING] Expected List of Layer Indices for Trigger Mask.\n";
+    }
+  } else if (command == _trigger_clear) {
+    Tracking::Trigger::Clear();
+  } else if (command == _trigger_require) {
+    Tracking::Trigger::SetRequired(_trigger_require->GetNewIntValue(value));
+  } else if (command == _trigger_window) {
+    Tracking::Trigger::SetWindow(_trigger_window->GetNewDoubleValue(value));
+  } else if (command == _trigger_threshold) {
+    Tracking::Trigger::SetThreshold(_trigger_threshold->GetNewDoubleValue(value));
+  } else if (command == _trigger_print) {
+    Tracking::Trigger::Print();
+  } else if (command == _truth) {
+    Tracking::SetTruthLevel(value);
+  } else {
+    for (std::size_t i{}; i < _regions.size(); ++i) {
+      if (command == _region_cut[i]) {
+        SetRegionCut(_regions[i], _region_cut[i]->GetNewDoubleValue(value));
+      } else if (command == _region_step[i]) {
+        SetRegionStep(_regions[i], _region_step[i]->GetNewDoubleValue(value));
+      }
+    }
   }
 }
 //----------------------------------------------------------------------------------------------
@@ -229,6 +889,115 @@ void Builder::SetDetector(const std::string& detector) {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Set Region Production Cut___________________________________________________________________
+void Builder::SetRegionCut(const std::string& region,
+                           double cut) {
+  _region_cuts[region] = cut;
+  _update_region(region);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Region Maximum Step Length______________________________________________________________
+void Builder::SetRegionStep(const std::string& region,
+                            double step) {
+  _region_steps[region] = step;
+  _update_region(region);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Update Cuts and Limits of All Regions_______________________________________________________
+void Builder::UpdateRegions() {
+  for (const auto& region : _regions)
+    _update_region(region);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Earth Construction Mode_________________________________________________________________
+void Builder::SetEarthMode(const std::string& mode) {
+  const auto decomposed = mode == "decomposed";
+  if (decomposed == Earth::Decomposed())
+    return;
+  Earth::Decomposed(decomposed);
+  SetDetector(_detector);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Compare Earth Construction Modes____________________________________________________________
+void Builder::CheckEarth(const std::size_t points) {
+  const auto world = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
+  if (!_earth || !world) {
+    std::cout << "[WARNING] Earth Check Requires a Constructed Geometry.\n";
+    return;
+  }
+
+  // the other mode is built into a separate world which is never closed or tracked
+  const auto decomposed = Earth::Decomposed();
+  Earth::Decomposed(!decomposed);
+  auto other_world = PlaceVolume(BoxVolume("CheckWorld", WorldLength, WorldLength, WorldLength - 700*m), nullptr);
+  const auto other_earth = _construct_earth(other_world->GetLogicalVolume());
+  Earth::Decomposed(decomposed);
+
+  MassBudget current_budget, other_budget;
+  _add_mass(_earth->GetLogicalVolume(), points, current_budget);
+  _add_mass(other_earth->GetLogicalVolume(), points, other_budget);
+  auto& boolean_budget = decomposed ? other_budget : current_budget;
+  auto& decomposed_budget = decomposed ? current_budget : other_budget;
+  for (const auto& entry : boolean_budget)
+    decomposed_budget[entry.first];
+  for (const auto& entry : decomposed_budget)
+    boolean_budget[entry.first];
+
+  std::cout << "Earth Mass Budget (boolean / decomposed):\n";
+  for (const auto& entry : boolean_budget) {
+    const auto other = decomposed_budget[entry.first];
+    std::cout << "  " << std::left << std::setw(12) << entry.first << std::right
+              << std::setw(14) << entry.second / kg << " kg " << std::setw(14) << other / kg << " kg "
+              << std::showpos << std::setw(10)
+              << (entry.second > 0 ? 100 * (other - entry.second) / entry.second : 0.0)
+              << std::noshowpos << "%\n";
+  }
+
+  G4Navigator current_navigator, other_navigator;
+  current_navigator.SetWorldVolume(world);
+  other_navigator.SetWorldVolume(other_world);
+  std::mt19937_64 engine(points);
+  std::uniform_real_distribution<double> uniform;
+  // each located point costs far more than a volume estimate point
+  const auto region_points = std::max<std::size_t>(1UL, points / 10);
+  std::cout << "Earth Material Mismatch (" << region_points << " points per region):\n";
+  for (const auto& region : _sample_regions()) {
+    const auto size = region.max - region.min;
+    std::size_t mismatch{};
+    for (std::size_t i{}; i < region_points; ++i) {
+      const auto point = G4ThreeVector(region.min.x() + uniform(engine) * size.x(),
+                                       region.min.y() + uniform(engine) * size.y(),
+                                       region.min.z() + uniform(engine) * size.z() + Earth::TotalShift());
+      if (_material_at(current_navigator, _earth, point) != _material_at(other_navigator, other_earth, point))
+        ++mismatch;
+    }
+    std::cout << "  " << std::left << std::setw(12) << region.name << std::right << std::setw(10) << mismatch
+              << " points, " << G4BestUnit(mismatch * size.x() * size.y() * size.z() / region_points, "Volume")
+              << "\n";
+  }
+
+  std::cout << "Earth Overlaps: " << _count_overlaps(_earth->GetLogicalVolume()) << "\n";
+
+  _delete_tree(other_world);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Lower Corner of Detector Envelope_______________________________________________________
+const G4ThreeVector& Builder::GetDetectorEnvelopeMin() {
+  return _envelope_min;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Upper Corner of Detector Envelope_______________________________________________________
+const G4ThreeVector& Builder::GetDetectorEnvelopeMax() {
+  return _envelope_max;
+}
+//----------------------------------------------------------------------------------------------
+
 //__Set Current Detector Save Option____________________________________________________________
 void Builder::SetSaveOption(bool option) {
   if (_detector == "Flat") {
@@ -399,16 +1168,39 @@ G4LogicalVolume* OpenBoxVolume(const std::string& name,
 G4VPhysicalVolume* PlaceVolume(const std::string& name,
                                G4LogicalVolume* current,
                                G4LogicalVolume* parent,
-                               const G4Transform3D& transform) {
-  return new G4PVPlacement(transform, current, name, parent, false, 0);
+                               const G4Transform3D& transform,
+                               const int copy) {
+  return new G4PVPlacement(transform, current, name, parent, false, copy);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Physical Volume Placer______________________________________________________________________
 G4VPhysicalVolume* PlaceVolume(G4LogicalVolume* current,
                                G4LogicalVolume* parent,
-                               const G4Transform3D& transform) {
-  return PlaceVolume(current->GetName(), current, parent, transform);
+                               const G4Transform3D& transform,
+                               const int copy) {
+  return PlaceVolume(current->GetName(), current, parent, transform, copy);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Parameterised Volume Placer_________________________________________________________________
+// the copy number of each placement is its index in transforms and the parameterised volume
+// must be the only daughter of its parent
+G4VPhysicalVolume* PlaceParameterised(G4LogicalVolume* current,
+                                      G4LogicalVolume* parent,
+                                      const std::vector<G4Transform3D>& transforms) {
+  return new G4PVParameterised(current->GetName(), current, parent, kUndefined,
+    transforms.size(), new TransformParameterisation(transforms));
+}
+//----------------------------------------------------------------------------------------------
+
+//__Replica Volume Placer_______________________________________________________________________
+G4VPhysicalVolume* PlaceReplica(G4LogicalVolume* current,
+                                G4LogicalVolume* parent,
+                                const EAxis axis,
+                                const int count,
+                                const double width) {
+  return new G4PVReplica(current->GetName(), current, parent, axis, count, width);
 }
 //----------------------------------------------------------------------------------------------
 
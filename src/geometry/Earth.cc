@@ -19,8 +19,11 @@
 
 #include <G4UnionSolid.hh>
 #include <G4SubtractionSolid.hh>
+#include <G4MultiUnion.hh>
 #include <tls.hh>
 
+#include <algorithm>
+
 #include "geometry/Construction.hh"
 
 namespace MATHUSLA { namespace MU {
@@ -46,6 +49,10 @@ static auto _marl_depth               =  1825.0L*cm;
 static auto _mix_depth                =  3645.0L*cm;
 //----------------------------------------------------------------------------------------------
 
+//__Earth Construction Mode_____________________________________________________________________
+static auto _decomposed = false;
+//----------------------------------------------------------------------------------------------
+
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 namespace Earth { //////////////////////////////////////////////////////////////////////////////
@@ -60,6 +67,9 @@ G4Material* Material::Mix       = nullptr;
 
 //__Define Earth Materials______________________________________________________________________
 void Material::Define() {
+  if (Material::CaCO3)
+    return;
+
   Material::CaCO3 = new G4Material("CaCO3", 2.71*g/cm3, 3);
   Material::CaCO3->AddElement(Construction::Material::Ca, 1);
   Material::CaCO3->AddElement(Construction::Material::C,  1);
@@ -107,6 +117,13 @@ long double LayerWidthY(long double value) {
   _layer_width_y = value;
   return LayerWidthY();
 }
+long double BufferZoneShiftX() {
+  return _buffer_zone_x_shift;
+}
+long double BufferZoneShiftX(long double value) {
+  _buffer_zone_x_shift = value;
+  return BufferZoneShiftX();
+}
 long double BufferZoneLength() {
   return _buffer_zone_length;
 }
@@ -185,6 +202,16 @@ long double TotalDepth() {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Earth Construction Mode_____________________________________________________________________
+bool Decomposed() {
+  return _decomposed;
+}
+bool Decomposed(bool value) {
+  _decomposed = value;
+  return Decomposed();
+}
+//----------------------------------------------------------------------------------------------
+
 G4VSolid* BufferZoneSolid() {
   auto higher_solid = Construction::Box("", BufferZoneLength() + safety_margin, BufferZoneHigherWidth(), BufferZoneHigherDepth() + safety_margin);
   auto lower_solid = Construction::Box("", BufferZoneLength() + safety_margin, BufferZoneLowerWidth(), BufferZoneLowerDepth());
@@ -194,8 +221,159 @@ G4VSolid* SX1Solid() {
   return Construction::Box("", BufferZoneLength(), SX1SlabWidth(), SX1SlabDepth() + safety_margin);
 }
 
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Axis-Aligned Block in Earth Coordinates_____________________________________________________
+// depths are measured downward from the top of the earth
+struct Block {
+  long double x0, x1, y0, y1, top, bottom;
+};
+using BlockList = std::vector<Block>;
+//----------------------------------------------------------------------------------------------
+
+//__Remove Empty Blocks_________________________________________________________________________
+BlockList _non_empty(BlockList blocks) {
+  blocks.erase(std::remove_if(blocks.begin(), blocks.end(), [](const Block& block) {
+    return block.x1 <= block.x0 || block.y1 <= block.y0 || block.bottom <= block.top; }),
+    blocks.end());
+  return blocks;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Split Block Around Hole Spanning its Full Depth_____________________________________________
+BlockList _frame(const Block& outer,
+                 long double x0,
+                 long double x1,
+                 long double y0,
+                 long double y1) {
+  x0 = std::max(x0, outer.x0);
+  x1 = std::min(x1, outer.x1);
+  y0 = std::max(y0, outer.y0);
+  y1 = std::min(y1, outer.y1);
+  if (x1 <= x0 || y1 <= y0)
+    return _non_empty({outer});
+  return _non_empty({{outer.x0, x0, outer.y0, outer.y1, outer.top, outer.bottom},
+                     {x1, outer.x1, outer.y0, outer.y1, outer.top, outer.bottom},
+                     {x0, x1, outer.y0, y0, outer.top, outer.bottom},
+                     {x0, x1, y1, outer.y1, outer.top, outer.bottom}});
+}
+//----------------------------------------------------------------------------------------------
+
+//__Append Blocks_______________________________________________________________________________
+void _append(BlockList& blocks,
+             const BlockList& other) {
+  blocks.insert(blocks.end(), other.cbegin(), other.cend());
+}
+//----------------------------------------------------------------------------------------------
+
+//__Block Solid and Placement in Earth__________________________________________________________
+G4Box* _box(const std::string& name,
+            const Block& block) {
+  return Construction::Box(name, block.x1 - block.x0, block.y1 - block.y0, block.bottom - block.top);
+}
+G4Transform3D _transform(const Block& block) {
+  return Construction::Transform(0.5L * (block.x0 + block.x1),
+                                 0.5L * (block.y0 + block.y1),
+                                 0.5L * (block.top + block.bottom - TotalDepth()));
+}
+//----------------------------------------------------------------------------------------------
+
+//__Place Blocks in Earth_______________________________________________________________________
+G4LogicalVolume* _place(const std::string& name,
+                        const BlockList& blocks,
+                        G4Material* material,
+                        const G4VisAttributes& attr,
+                        G4LogicalVolume* earth) {
+  G4LogicalVolume* out = nullptr;
+  for (const auto& block : blocks) {
+    out = Construction::Volume(_box(name, block), material, attr);
+    Construction::PlaceVolume(out, earth, _transform(block));
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Buffer Zone Boundaries______________________________________________________________________
+// same extent as BufferZoneSolid, including the safety margin
+long double _buffer_zone_x0() {
+  return _buffer_zone_x_shift - 0.5L * (BufferZoneLength() + safety_margin);
+}
+long double _buffer_zone_x1() {
+  return _buffer_zone_x_shift + 0.5L * (BufferZoneLength() + safety_margin);
+}
+long double _buffer_zone_higher_bottom() {
+  return BufferZoneHigherDepth() + 0.5L * safety_margin;
+}
+long double _buffer_zone_lower_bottom() {
+  return BufferZoneHigherDepth() + BufferZoneLowerDepth();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Earth Volume Blocks Around Buffer Zone______________________________________________________
+BlockList _earth_blocks() {
+  const auto x = 0.5L * LayerWidthX();
+  const auto y = 0.5L * LayerWidthY();
+  const auto higher_y = 0.5L * BufferZoneHigherWidth();
+  const auto lower_y = 0.5L * BufferZoneLowerWidth();
+  auto out = _frame({-x, x, -y, y, 0.0L, _buffer_zone_higher_bottom()},
+                    _buffer_zone_x0(), _buffer_zone_x1(), -higher_y, higher_y);
+  _append(out, _frame({-x, x, -y, y, _buffer_zone_higher_bottom(), _buffer_zone_lower_bottom()},
+                      _buffer_zone_x0(), _buffer_zone_x1(), -lower_y, lower_y));
+  _append(out, _non_empty({{-x, x, -y, y, _buffer_zone_lower_bottom(), TotalDepth()}}));
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__SX1 Slab Blocks Around Buffer Zone__________________________________________________________
+BlockList _sx1_slab_blocks() {
+  const auto x0 = _buffer_zone_x_shift - 0.5L * BufferZoneLength();
+  const auto x1 = _buffer_zone_x_shift + 0.5L * BufferZoneLength();
+  const auto y = 0.5L * SX1SlabWidth();
+  const auto higher_y = 0.5L * BufferZoneHigherWidth();
+  const auto lower_y = 0.5L * BufferZoneLowerWidth();
+  const auto higher_bottom = std::min(_buffer_zone_higher_bottom(), SX1SlabDepth());
+  const auto lower_bottom = std::min(_buffer_zone_lower_bottom(), SX1SlabDepth());
+  auto out = _frame({x0, x1, -y, y, 0.0L, higher_bottom},
+                    _buffer_zone_x0(), _buffer_zone_x1(), -higher_y, higher_y);
+  _append(out, _frame({x0, x1, -y, y, higher_bottom, lower_bottom},
+                      _buffer_zone_x0(), _buffer_zone_x1(), -lower_y, lower_y));
+  _append(out, _non_empty({{x0, x1, -y, y, lower_bottom, SX1SlabDepth()}}));
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Sandstone Blocks Around SX1 Slab____________________________________________________________
+// next to the buffer zone the hole follows its safety margin, so no block leaves the earth
+BlockList _sandstone_frame_blocks() {
+  const auto x = 0.5L * LayerWidthX();
+  const auto y = 0.5L * LayerWidthY();
+  const auto slab_x0 = _buffer_zone_x_shift - 0.5L * BufferZoneLength();
+  const auto slab_x1 = _buffer_zone_x_shift + 0.5L * BufferZoneLength();
+  const auto slab_y = 0.5L * SX1SlabWidth();
+  const auto buffer_bottom = std::min(_buffer_zone_lower_bottom(), SandstoneDepth());
+  const auto slab_bottom = std::min(SX1SlabDepth(), SandstoneDepth());
+  auto out = _frame({-x, x, -y, y, 0.0L, buffer_bottom},
+                    std::min(slab_x0, _buffer_zone_x0()), std::max(slab_x1, _buffer_zone_x1()),
+                    -std::max(slab_y, 0.5L * BufferZoneHigherWidth()),
+                    std::max(slab_y, 0.5L * BufferZoneHigherWidth()));
+  _append(out, _frame({-x, x, -y, y, buffer_bottom, slab_bottom},
+                      slab_x0, slab_x1, -slab_y, slab_y));
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
 //__Earth Logical Volumes_______________________________________________________________________
 G4LogicalVolume* Volume() {
+  if (Decomposed()) {
+    auto earth_solid = new G4MultiUnion("Earth");
+    for (const auto& block : _earth_blocks())
+      earth_solid->AddNode(*_box("", block), _transform(block));
+    earth_solid->Voxelize();
+    return Construction::Volume(earth_solid);
+  }
+
   auto earth_box = Construction::Box("", LayerWidthX(), LayerWidthY(), TotalDepth());
 
   auto earth_solid = new G4SubtractionSolid("Earth", earth_box, BufferZoneSolid(), Construction::Transform(_buffer_zone_x_shift, 0.0, 0.5 * (BufferZoneHigherDepth() - TotalDepth())));
@@ -244,14 +422,42 @@ const G4Translate3D MixTransform() {
 }
 //----------------------------------------------------------------------------------------------
 
+//__Place Earth Layers as Boxes_________________________________________________________________
+std::vector<Layer> PlaceDecomposedLayers(G4LogicalVolume* earth) {
+  const auto x = 0.5L * LayerWidthX();
+  const auto y = 0.5L * LayerWidthY();
+  const auto sandstone_top = std::min(std::max(SX1SlabDepth(), _buffer_zone_lower_bottom()), SandstoneDepth());
+  const auto marl_top = SandstoneDepth();
+  const auto mix_top = marl_top + MarlDepth();
+
+  _place("SX1Slab", _sx1_slab_blocks(), Construction::Material::Concrete, Construction::BorderAttributes(), earth);
+  _place("Sandstone", _sandstone_frame_blocks(), Material::SiO2, Construction::BorderAttributes(), earth);
+
+  std::vector<Layer> out;
+  const auto sandstone = _place("Sandstone", _non_empty({{-x, x, -y, y, sandstone_top, marl_top}}),
+    Material::SiO2, Construction::BorderAttributes(), earth);
+  if (sandstone)
+    out.push_back({sandstone, sandstone_top, marl_top});
+  out.push_back({_place("Marl", {{-x, x, -y, y, marl_top, mix_top}}, Material::Marl, G4VisAttributes(), earth),
+                 marl_top, mix_top});
+  out.push_back({_place("Mix", {{-x, x, -y, y, mix_top, TotalDepth()}}, Material::Mix, G4VisAttributes(), earth),
+                 mix_top, TotalDepth()});
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
 //__Construct Earth_____________________________________________________________________________
 G4VPhysicalVolume* Construct(G4LogicalVolume* world) {
   Material::Define();
   auto earth = Volume();
-  Construction::PlaceVolume(SX1SlabVolume(), earth, SX1SlabTransform());
-  Construction::PlaceVolume(SandstoneVolume(), earth, SandstoneTransform());
-  Construction::PlaceVolume(MarlVolume(), earth, MarlTransform());
-  Construction::PlaceVolume(MixVolume(), earth, MixTransform());
+  if (Decomposed()) {
+    PlaceDecomposedLayers(earth);
+  } else {
+    Construction::PlaceVolume(SX1SlabVolume(), earth, SX1SlabTransform());
+    Construction::PlaceVolume(SandstoneVolume(), earth, SandstoneTransform());
+    Construction::PlaceVolume(MarlVolume(), earth, MarlTransform());
+    Construction::PlaceVolume(MixVolume(), earth, MixTransform());
+  }
   return Construction::PlaceVolume(earth, world, Transform());
 }
 //----------------------------------------------------------------------------------------------
@@ -34,7 +34,8 @@ bool Detector::SaveAll = false;
 //__Detector Constructor________________________________________________________________________
 Detector::Detector() : G4VSensitiveDetector("MATHUSLA/MU/MuonMapper") {
   collectionName.insert("MuonMapper_HC");
-  _box->SetSensitiveDetector(this);
+  if (_box)
+    _box->SetSensitiveDetector(this);
 }
 //----------------------------------------------------------------------------------------------
 
@@ -55,11 +56,9 @@ G4bool Detector::ProcessHits(G4Step* step, G4TouchableHistory*) {
     const auto process_name = process->GetProcessName();
     if (process_name == "Transportation" && track->GetVolume() == track->GetNextVolume()) {
       const auto kinetic = track->GetKineticEnergy() / MeV; // from GeV correction
-      /*
-      Analysis::ROOT::FillNTuple(DataPrefix, 0, {
+      Analysis::ROOT::FillNTuple(DataName, DataKeyTypes, {
         (track->GetPosition() - G4ThreeVector(0, 0, 100*m)).mag() / m,
-        static_cast<double>(std::log10(std::sqrt(kinetic*kinetic + 2*kinetic*mass) / mass))});
-      */
+        static_cast<double>(std::log10(std::sqrt(kinetic*kinetic + 2*kinetic*mass) / mass))}, {});
       track->SetTrackStatus(fStopAndKill);
       return true;
     }
@@ -32,16 +32,31 @@ namespace { ////////////////////////////////////////////////////////////////////
 std::vector<Layer*> _layers;
 //----------------------------------------------------------------------------------------------
 
-//__Flat Hit Collection_________________________________________________________________________
-G4ThreadLocal Tracking::HitCollection* _hit_collection;
+//__Flat Detector Encoder_______________________________________________________________________
+// scintillators share one volume inside their layer and layers are placed with their index as
+// copy number, so the ID is a thousand times the layer number plus the scintillator copy number.
+// Steps of one track in one scintillator are merged into a single hit.
+struct _encoder : Tracking::BasicEncoder {
+  static constexpr bool Aggregate = true;
+
+  static int Encode(const G4Step* step) {
+    const auto touchable = step->GetTrack()->GetTouchable();
+    return 1000 * (1 + touchable->GetCopyNumber(2)) + touchable->GetCopyNumber(1);
+  }
+
+  static std::string Name(const int id) {
+    return "L" + std::to_string(id / 1000) + std::to_string(id % 1000);
+  }
+};
+using _pipeline = Tracking::DetectorPipeline<_encoder>;
 //----------------------------------------------------------------------------------------------
 
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 //__Flat Data Variables_________________________________________________________________________
 const std::string& Detector::DataName = "flat_run";
-const Analysis::ROOT::DataKeyList Detector::DataKeys = Analysis::ROOT::DefaultDataKeyList;
-const Analysis::ROOT::DataKeyTypeList Detector::DataKeyTypes = Analysis::ROOT::DefaultDataKeyTypeList;
+const Analysis::ROOT::DataKeyList Detector::DataKeys = _pipeline::DataKeys();
+const Analysis::ROOT::DataKeyTypeList Detector::DataKeyTypes = _pipeline::DataKeyTypes();
 bool Detector::SaveAll = false;
 //----------------------------------------------------------------------------------------------
 
@@ -55,21 +70,19 @@ Detector::Detector() : G4VSensitiveDetector("MATHUSLA/MU/Flat") {
 
 //__Initalize Event_____________________________________________________________________________
 void Detector::Initialize(G4HCofThisEvent* event) {
-  _hit_collection = Tracking::GenerateHitCollection(this, event);
+  _pipeline::Initialize(this, event);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Hit Processing______________________________________________________________________________
 G4bool Detector::ProcessHits(G4Step* step, G4TouchableHistory*) {
-  _hit_collection->insert(new Tracking::Hit(step));
-  return true;
+  return _pipeline::ProcessHit(step);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Post-Event Processing_______________________________________________________________________
 void Detector::EndOfEvent(G4HCofThisEvent*) {
-  if (verboseLevel >= 2 && _hit_collection)
-    std::cout << *_hit_collection;
+  _pipeline::EndOfEvent(DataName, DataKeyTypes, SaveAll, verboseLevel);
 }
 //----------------------------------------------------------------------------------------------
 
@@ -89,9 +102,9 @@ G4VPhysicalVolume* Detector::Construct(G4LogicalVolume* world) {
   auto L2 = new Layer("L2", 90, S1);
   auto L3 = new Layer("L3", 90, S1);
 
-  L1->PlaceIn(DetectorVolume, Construction::Transform(0, 0, 0*m, 1, 0, 0, 90*deg));
-  L2->PlaceIn(DetectorVolume, Construction::Transform(0, 0, 1*m, 1, 0, 0, 90*deg));
-  L3->PlaceIn(DetectorVolume, Construction::Transform(0, 0, 2*m, 1, 0, 0, 90*deg));
+  L1->PlaceIn(DetectorVolume, Construction::Transform(0, 0, 0*m, 1, 0, 0, 90*deg), 0);
+  L2->PlaceIn(DetectorVolume, Construction::Transform(0, 0, 1*m, 1, 0, 0, 90*deg), 1);
+  L3->PlaceIn(DetectorVolume, Construction::Transform(0, 0, 2*m, 1, 0, 0, 90*deg), 2);
 
   _layers = {L1, L2, L3};
 
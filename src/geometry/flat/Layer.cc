@@ -27,40 +27,41 @@ namespace Flat { ///////////////////////////////////////////////////////////////
 Layer::Layer(const std::string& name,
              const size_t count,
              const Scintillator* scintillator)
-    : _volume(nullptr), _placement(nullptr), _name(name), _count(count) {
+    : _scintillator(nullptr), _volume(nullptr), _placement(nullptr), _name(name), _count(count) {
 
   const auto&& shift = scintillator->base_width + ScintillatorSpacing;
   const auto&& full_width = (count - 1) * shift + scintillator->GetFullWidth();
 
   _volume = Construction::BoxVolume(_name, full_width, scintillator->height, scintillator->length);
 
+  // neighbouring scintillators interlock so their extents overlap and cannot be replica slices,
+  // and GDML cannot write a parameterised union solid, so one volume is placed count times
+  _scintillator = Scintillator::Clone(scintillator, _name + "_" + scintillator->name);
   for (size_t i = 0; i < count; ++i) {
-    auto clone = Scintillator::Clone(scintillator, _name + std::to_string(i));
-    clone->pvolume = Construction::PlaceVolume(clone->lvolume, _volume,
-      Construction::Transform(i * shift + 0.5 * (scintillator->GetFullWidth() - full_width), 0, 0));
-    _scintillators.push_back(clone);
+    _scintillator->pvolume = Construction::PlaceVolume(_scintillator->lvolume, _volume,
+      Construction::Transform(i * shift + 0.5 * (scintillator->GetFullWidth() - full_width), 0, 0), i);
   }
 }
 //----------------------------------------------------------------------------------------------
 
 //__Register Layer with Detector________________________________________________________________
 void Layer::Register(G4VSensitiveDetector* detector) {
-  for (auto& sci : _scintillators)
-    sci->sensitive->GetLogicalVolume()->SetSensitiveDetector(detector);
+  _scintillator->sensitive->GetLogicalVolume()->SetSensitiveDetector(detector);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Place Layer in the Detector_________________________________________________________________
 G4VPhysicalVolume* Layer::PlaceIn(G4LogicalVolume* parent,
-                                  const G4Transform3D& transform) {
-  return (_placement = Construction::PlaceVolume(_volume, parent, transform));
+                                  const G4Transform3D& transform,
+                                  const int copy) {
+  return (_placement = Construction::PlaceVolume(_volume, parent, transform, copy));
 }
 //----------------------------------------------------------------------------------------------
 
 //__Clone Layer_________________________________________________________________________________
 Layer* Layer::Clone(const Layer& other,
                     const std::string& new_name) {
-  return new Layer(new_name, other._count, other._scintillators.front());
+  return new Layer(new_name, other._count, other._scintillator);
 }
 //----------------------------------------------------------------------------------------------
 
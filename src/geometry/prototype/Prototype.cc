@@ -17,17 +17,17 @@
 
 #include "geometry/Prototype.hh"
 
-#include <unordered_map>
 #include <cstddef>
 #include <algorithm>
 #include <cmath>
 #include <string>
 
 #include <G4HCofThisEvent.hh>
+#include <G4PhysicalVolumeStore.hh>
+#include <G4Point3D.hh>
 #include <G4Step.hh>
 #include <tls.hh>
 
-#include "action.hh"
 #include "analysis.hh"
 #include "geometry/Cavern.hh"
 #include "physics/Units.hh"
@@ -46,169 +46,114 @@ std::vector<RPC*> _rpcs;
 std::vector<UChannel *> _uchannels;
 //----------------------------------------------------------------------------------------------
 
-//__Prototype Hit Collection____________________________________________________________________
-G4ThreadLocal Tracking::HitCollection* _hit_collection;
+//__Global to Local Transforms by Scintillator ID_______________________________________________
+G4ThreadLocal std::vector<G4Transform3D>* _scintillator_frames = nullptr;
 //----------------------------------------------------------------------------------------------
 
-//__Encoding/Decoding Maps______________________________________________________________________
-G4ThreadLocal std::unordered_map<std::string, Scintillator*> _scintillator_map;
-G4ThreadLocal std::unordered_map<std::string, double>        _encoding;
-G4ThreadLocal std::unordered_map<int, std::string>           _decoding;
+//__Prototype Detector Encoder__________________________________________________________________
+// strips are replicated inside parameterised pads inside the pad plane of an RPC and
+// scintillators are placed in the prototype with their index as copy number. Every hit also
+// carries its distances to the PMT in the frame of its scintillator, which are zero for strips.
+struct _encoder : Tracking::BasicEncoder {
+  static constexpr std::size_t ColumnCount = 3UL;
+
+  static double MinDeposit() {
+    return Scintillator::MinDeposit < RPC::MinDeposit ? Scintillator::MinDeposit : RPC::MinDeposit;
+  }
+
+  static Analysis::ROOT::DataKeyList ColumnKeys() {
+    return {"PMT_UP", "PMT_RIGHT", "PMT_R"};
+  }
+
+  static int Encode(const G4Step* step) {
+    const auto touchable = step->GetTrack()->GetTouchable();
+    return touchable->GetVolume()->IsReplicated()
+      ? Detector::StripID(touchable->GetCopyNumber(3), touchable->GetCopyNumber(1), touchable->GetCopyNumber(0))
+      : touchable->GetCopyNumber(1);
+  }
+
+  static std::string Name(const int id) {
+    return Detector::DecodeDetector(id);
+  }
+
+  static std::array<double, ColumnCount> Columns(const G4Step* step,
+                                                 const int id) {
+    Scintillator::PMTPoint pmt_point{0, 0, 0};
+    if (id < static_cast<int>(_scintillator_frames->size())) {
+      const G4ThreeVector local = (*_scintillator_frames)[id] * G4Point3D(step->GetPostStepPoint()->GetPosition());
+      pmt_point = Scintillator::PMTDistance(local, Table::Scintillators[id]);
+    }
+    return {{pmt_point.up / Units::Length, pmt_point.right / Units::Length, pmt_point.r / Units::Length}};
+  }
+};
+using _pipeline = Tracking::DetectorPipeline<_encoder>;
 //----------------------------------------------------------------------------------------------
 
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 //__Prototype Data Variables____________________________________________________________________
 const std::string& Detector::DataName = "prototype_run";
-const Analysis::ROOT::DataKeyList Detector::DataKeys = Analysis::ROOT::DefaultDataKeyList;
-const Analysis::ROOT::DataKeyTypeList Detector::DataKeyTypes = Analysis::ROOT::DefaultDataKeyTypeList;
+const Analysis::ROOT::DataKeyList Detector::DataKeys = _pipeline::DataKeys();
+const Analysis::ROOT::DataKeyTypeList Detector::DataKeyTypes = _pipeline::DataKeyTypes();
 bool Detector::SaveAll = false;
 //----------------------------------------------------------------------------------------------
 
 //__Prototype Constructor_______________________________________________________________________
 Detector::Detector() : G4VSensitiveDetector("MATHUSLA/MU/Prototype") {
   collectionName.insert("Prototype_HC");
-  for (auto scintillator : _scintillators) {
+  for (auto scintillator : _scintillators)
     scintillator->Register(this);
-    const auto name = scintillator->GetFullName();
-    const auto id = _decoding.size();
-    _scintillator_map.insert({name, scintillator});
-    _encoding.insert({name, id});
-    _decoding.insert({id, name});
-  }
-  for (auto rpc : _rpcs) {
+  for (auto rpc : _rpcs)
     rpc->Register(this);
-    for (const auto& pad : rpc->GetPadList()) {
-      for (const auto& volume : pad->pvolume_strips) {
-        const auto& name = volume->GetName();
-        const auto id = std::stoi(name);
-        _encoding.insert({name, id});
-        _decoding.insert({id, name});
-      }
-    }
+
+  // the prototype placement is read back from the geometry so cached worlds work as well
+  if (!_scintillator_frames)
+    _scintillator_frames = new std::vector<G4Transform3D>;
+  _scintillator_frames->clear();
+  const auto prototype = G4PhysicalVolumeStore::GetInstance()->GetVolume("Prototype", false);
+  if (prototype) {
+    const G4Transform3D placement(prototype->GetObjectRotationValue(), prototype->GetObjectTranslation());
+    for (const auto& info : Table::Scintillators)
+      _scintillator_frames->push_back((placement * Scintillator::Transform(info)).inverse());
   }
 }
 //----------------------------------------------------------------------------------------------
 
 //__Initalize Event_____________________________________________________________________________
 void Detector::Initialize(G4HCofThisEvent* event) {
-  _hit_collection = Tracking::GenerateHitCollection(this, event);
+  _pipeline::Initialize(this, event);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Hit Processing______________________________________________________________________________
 G4bool Detector::ProcessHits(G4Step* step, G4TouchableHistory*) {
-  const auto deposit = step->GetTotalEnergyDeposit();
-
-  const auto min_deposit = Scintillator::MinDeposit < RPC::MinDeposit ?
-                           Scintillator::MinDeposit : RPC::MinDeposit;
-
-  if (!deposit || deposit < min_deposit)
-    return false;
-
-  const auto track       = step->GetTrack();
-  const auto trackID     = track->GetTrackID();
-  const auto particle    = track->GetParticleDefinition();
-  const auto history     = track->GetTouchable()->GetHistory();
-  const auto name        = history->GetTopVolume()->GetName();
-  const auto post_step   = step->GetPostStepPoint();
-
-  const auto global_time = post_step->GetGlobalTime()  / Units::Time;
-  const auto position    = post_step->GetPosition()    / Units::Length;
-  const auto energy      = post_step->GetTotalEnergy() / Units::Energy;
-  const auto momentum    = post_step->GetMomentum()    / Units::Momentum;
-
-  _hit_collection->insert(
-    new Tracking::Hit(
-      particle,
-      trackID,
-      track->GetParentID(),
-      name,
-      deposit / Units::Energy,
-      G4LorentzVector(global_time, position),
-      G4LorentzVector(energy, momentum)));
-
-  /* FIXME: add back to data
-  Scintillator::PMTPoint pmt_point{0, 0, 0};
-  if (detector_id < 100) {
-    const auto sci = _scintillator_map[name];
-
-    const auto& volume1 = history->GetVolume(history->GetDepth() - 1);
-    const auto& volume2 = history->GetVolume(history->GetDepth() - 2);
-    const auto& volume3 = history->GetVolume(history->GetDepth() - 3);
-    const auto& volume4 = history->GetVolume(history->GetDepth() - 4);
-
-    const auto& t1 = volume1->GetObjectTranslation();
-    const auto& t2 = volume2->GetObjectTranslation();
-    const auto& t3 = volume3->GetObjectTranslation();
-    const auto& t4 = volume4->GetObjectTranslation();
-
-    const auto& r2 = volume2->GetObjectRotationValue();
-    const auto& r3 = volume3->GetObjectRotationValue();
-    const auto& r4 = volume4->GetObjectRotationValue();
-
-    const auto translation = r4 * (r3 * (r2 * (t1) + t2) + t3) + t4;
-    const auto rotation = (r4*r3*r2).inverse();
-
-    if (sci)
-      pmt_point = Scintillator::PMTDistance(position, sci, translation, rotation);
-  }
-  */
-
-  return true;
+  return _pipeline::ProcessHit(step);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Post-Event Processing_______________________________________________________________________
 void Detector::EndOfEvent(G4HCofThisEvent*) {
-  if (_hit_collection->GetSize() == 0 && !SaveAll)
-    return;
-
-  const auto collection_data = Tracking::ConvertToAnalysis(_hit_collection, _encoding);
-
-  Analysis::ROOT::DataEntryList root_data;
-  root_data.reserve(24);
-  root_data.push_back(collection_data[0]);
-  root_data.push_back(collection_data[1]);
-  root_data.push_back(collection_data[2]);
-  root_data.push_back(collection_data[3]);
-  root_data.push_back(collection_data[4]);
-  root_data.push_back(collection_data[5]);
-  root_data.push_back(collection_data[6]);
-  root_data.push_back(collection_data[7]);
-  root_data.push_back(collection_data[8]);
-  root_data.push_back(collection_data[9]);
-  root_data.push_back(collection_data[10]);
-  root_data.push_back(collection_data[11]);
-  root_data.push_back(collection_data[12]);
-  root_data.push_back(collection_data[13]);
-
-  const auto gen_particle_data = SaveAll ? Tracking::ConvertToAnalysis(GeneratorAction::GetLastEvent())
-                                         : Tracking::ConvertToAnalysis(EventAction::GetEvent());
-  const auto extra_gen_data = Tracking::ConvertToAnalysis(GeneratorAction::GetGenerator()->ExtraDetails());
-  root_data.insert(root_data.cend(), gen_particle_data.cbegin(), gen_particle_data.cend());
-  root_data.insert(root_data.cend(), extra_gen_data.cbegin(), extra_gen_data.cend());
-
-  Analysis::ROOT::DataEntry metadata;
-  metadata.reserve(2);
-  metadata.push_back(collection_data[0].size());
-  metadata.push_back(gen_particle_data[0].size());
-
-  Analysis::ROOT::FillNTuple(DataName, Detector::DataKeyTypes, metadata, root_data);
-  if (verboseLevel >= 2 && _hit_collection)
-    std::cout << *_hit_collection;
+  _pipeline::EndOfEvent(DataName, DataKeyTypes, SaveAll, verboseLevel);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Detector Encoding___________________________________________________________________________
 int Detector::EncodeDetector(const std::string& name) {
-  return _encoding[name];
+  return Table::EncodeDetector(name);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Detector Decoding___________________________________________________________________________
 const std::string Detector::DecodeDetector(int id) {
-  return _decoding[id];
+  return Table::DecodeDetector(id);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Strip Detector ID from RPC, Pad, and Strip Copy Numbers_____________________________________
+int Detector::StripID(int rpc,
+                      int pad,
+                      int strip) {
+  return Table::StripID(rpc, pad, strip);
 }
 //----------------------------------------------------------------------------------------------
 
@@ -226,38 +171,33 @@ G4VPhysicalVolume* Detector::Construct(G4LogicalVolume* world) {
                                                 3500 * mm,
                                                 total_outer_box_height);
 
-  for (const auto& scintillator_info : Scintillator::InfoArray) {
+  for (const auto& scintillator_info : Table::Scintillators) {
     auto scintillator = new Scintillator(scintillator_info.name,
                                          scintillator_info.trapezoid_height,
                                          scintillator_info.short_base,
                                          scintillator_info.long_base);
     scintillator->pvolume = Construction::PlaceVolume(scintillator->lvolume, DetectorVolume,
-      G4Transform3D(
-        G4RotationMatrix(G4ThreeVector(0.0, 0.0, 1.0),
-                         scintillator_info.z_rotation_angle) * G4RotationMatrix(G4ThreeVector(1.0, 0.0, 0.0), 90 * deg),
-        G4ThreeVector(scintillator_info.x, scintillator_info.y, scintillator_info.z)
-      )
-    );
+      Scintillator::Transform(scintillator_info), _scintillators.size());
     _scintillators.push_back(scintillator);
   }
 
   for (std::size_t rpc_index{}; rpc_index < RPC::Count; rpc_index++) {
     auto rpc = new RPC(rpc_index);
-    const auto& info = RPC::InfoArray[rpc_index];
+    const auto& info = Table::RPCs[rpc_index];
     rpc->PlaceIn(DetectorVolume, Construction::Transform(
       info.x, info.y, info.z, 0.0, 0.0, 1.0, info.z_rotation_angle));
     _rpcs.push_back(rpc);
   }
 
-  for (const auto &uchannel_info : UChannel::InfoArray) {
+  for (const auto &uchannel_info : Table::UChannels) {
     auto uchannel = new UChannel(uchannel_info.name, uchannel_info.length);
     Construction::PlaceVolume(uchannel->getLogicalVolume(), DetectorVolume, Construction::Transform(uchannel_info.x, uchannel_info.y, uchannel_info.z, 0.0, 0.0, 1.0, uchannel_info.z_rotation_angle));
     _uchannels.push_back(uchannel);
   }
 
   for (std::size_t rpc_sublayer_index = 0; rpc_sublayer_index < RPC::Count / 2; ++rpc_sublayer_index) {
-    const auto &rpc_1_info = RPC::InfoArray[2 * rpc_sublayer_index];
-    const auto &rpc_2_info = RPC::InfoArray[2 * rpc_sublayer_index + 1];
+    const auto &rpc_1_info = Table::RPCs[2 * rpc_sublayer_index];
+    const auto &rpc_2_info = Table::RPCs[2 * rpc_sublayer_index + 1];
     const auto average_rpc_x = (rpc_1_info.x + rpc_2_info.x) / 2.0;
     const auto average_rpc_y = (rpc_1_info.y + rpc_2_info.y) / 2.0;
     const auto max_rpc_z = std::max(rpc_1_info.z, rpc_2_info.z);
@@ -36,29 +36,8 @@ constexpr auto atlas_gas_sf6_fraction       = 0.003;
 
 namespace Prototype { //////////////////////////////////////////////////////////////////////////
 
-//__RPC Info____________________________________________________________________________________
-const RPC::Info RPC::InfoArray[RPC::Count] = {
-  { 616.85*mm,   87.79*mm, -2486.38*mm,  0.14719*rad},
-  {-618.50*mm, -108.63*mm, -2383.38*mm,  0.14753*rad},
-  { -85.73*mm,  616.81*mm, -2049.38*mm, -1.42123*rad},
-  {  98.09*mm, -615.71*mm, -2148.38*mm, -1.42069*rad},
-  { 616.12*mm,  -94.51*mm,  -651.13*mm,  2.98398*rad},
-  {-614.31*mm,  107.15*mm,  -751.13*mm,  2.98463*rad},
-  {  94.86*mm,  620.81*mm,  -408.13*mm,  1.41717*rad},
-  { -93.55*mm, -614.15*mm,  -311.13*mm,  1.41976*rad},
-  { 615.11*mm, -118.18*mm,   983.12*mm,  2.94831*rad},
-  {-610.33*mm,  122.71*mm,  1081.12*mm,  2.95236*rad},
-  { 120.28*mm,  616.35*mm,  1423.12*mm,  1.37958*rad},
-  {-147.19*mm, -601.52*mm,  1323.12*mm,  1.38013*rad}
-};
-//----------------------------------------------------------------------------------------------
-
-//__RPC Pad Constructor_________________________________________________________________________
-RPC::Pad::Pad(int input_id) : id(input_id) {}
-//----------------------------------------------------------------------------------------------
-
 //__RPC Constructor_____________________________________________________________________________
-RPC::RPC(int input_id) : _pads(), _id(input_id), _name("RPC" + std::to_string(1 + input_id)) {
+RPC::RPC(int input_id) : _id(input_id), _name("RPC" + std::to_string(1 + input_id)), _placement(nullptr) {
   auto outer_solid = Construction::Box("", OuterCasingWidth, OuterCasingHeight, OuterCasingDepth);
 
   _volume = Construction::Volume(_name, outer_solid);
@@ -148,36 +127,30 @@ RPC::RPC(int input_id) : _pads(), _id(input_id), _name("RPC" + std::to_string(1
   z_shift += (ThickFoamDepth + AluminumDepth) / 2.0;
   Construction::PlaceVolume(aluminum_sheet, _volume, G4Translate3D(0.0, 0.0, z_shift));
 
-  const auto id_name = (_id < 9 ? "0" : "") + std::to_string(1 + _id);
+  _strip = Construction::BoxVolume(_name + "_Strip",
+                                   StripWidth, StripHeight, StripDepth,
+                                   Material::Gas,
+                                   Construction::SensitiveAttributes());
+
+  _pad = Construction::BoxVolume(_name + "_Pad", PadWidth, PadHeight, PadDepth);
+  Construction::PlaceReplica(_strip, _pad, kYAxis, StripsPerPad, StripSpacingY);
 
+  std::vector<G4Transform3D> pad_transforms;
+  pad_transforms.reserve(PadsPerRPC);
   for (std::size_t pad_index{}; pad_index < PadsPerRPC; ++pad_index) {
-    auto pad = new Pad(pad_index);
-
-    pad->lvolume = Construction::BoxVolume("PAD" + std::to_string(1 + pad_index),
-                                           PadWidth, PadHeight, PadDepth);
-
-    const auto pad_name = id_name + (pad_index < 9 ? "0" : "") + std::to_string(1 + pad_index);
-
-    for (std::size_t strip_index{}; strip_index < StripsPerPad; ++strip_index) {
-      auto strip = Construction::BoxVolume(
-        pad_name + std::to_string(1 + strip_index),
-        StripWidth, StripHeight, StripDepth,
-        Material::Gas,
-        Construction::SensitiveAttributes());
-      pad->lvolume_strips.push_back(strip);
-      pad->pvolume_strips.push_back(Construction::PlaceVolume(strip, pad->lvolume,
-        G4Translate3D(0.0, (strip_index - (StripsPerPad - 1) / 2.0) * StripSpacingY, 0.0)));
-    }
-
-    pad->pvolume = Construction::PlaceVolume(pad->lvolume, _volume,
-      Construction::Transform(
-        (pad_index % PadsPerRow - (PadsPerRow - 1) / 2.0) * PadSpacingX,
-        (pad_index / PadsPerRow - (PadsPerColumn - 1) / 2.0) * PadSpacingY,
-        0.0,
-        0.0, 0.0, 1.0, pad_index % 2 ? 3.14159265358979323846264 : 0.0));
-
-    _pads.push_back(pad);
+    pad_transforms.push_back(Construction::Transform(
+      (pad_index % PadsPerRow - (PadsPerRow - 1) / 2.0) * PadSpacingX,
+      (pad_index / PadsPerRow - (PadsPerColumn - 1) / 2.0) * PadSpacingY,
+      0.0,
+      0.0, 0.0, 1.0, pad_index % 2 ? 3.14159265358979323846264 : 0.0));
   }
+
+  auto pad_plane = Construction::BoxVolume(_name + "_PadPlane",
+                                           PadsPerRow * PadSpacingX - (PadSpacingX - PadWidth),
+                                           PadsPerColumn * PadSpacingY,
+                                           PadDepth);
+  Construction::PlaceParameterised(_pad, pad_plane, pad_transforms);
+  Construction::PlaceVolume(pad_plane, _volume);
 }
 //----------------------------------------------------------------------------------------------
 
@@ -227,16 +200,14 @@ void RPC::Material::Define() {
 
 //__Register RPC with Detector__________________________________________________________________
 void RPC::Register(G4VSensitiveDetector* detector) {
-  for (const auto& pad : _pads)
-    for (const auto& volume : pad->lvolume_strips)
-      volume->SetSensitiveDetector(detector);
+  _strip->SetSensitiveDetector(detector);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Place RPC in RPC Layer______________________________________________________________________
 G4VPhysicalVolume* RPC::PlaceIn(G4LogicalVolume* parent,
                                 const G4Transform3D& transform) {
-  return (_placement = Construction::PlaceVolume(_volume, parent, transform));
+  return (_placement = Construction::PlaceVolume(_volume, parent, transform, _id));
 }
 //----------------------------------------------------------------------------------------------
 
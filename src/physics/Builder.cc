@@ -0,0 +1,239 @@
+/*
+ * src/physics/Builder.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "physics/Builder.hh"
+
+#include <map>
+
+#include <G4RunManager.hh>
+#include <G4VPhysicsConstructor.hh>
+#include <G4PhysicsListHelper.hh>
+#include <G4MuonPlus.hh>
+#include <G4MuonMinus.hh>
+#include <G4MuonNuclearProcess.hh>
+#include <G4MuonVDNuclearModel.hh>
+#include <G4EmStandardPhysics.hh>
+#include <G4DecayPhysics.hh>
+#include <G4StepLimiterPhysics.hh>
+#include <G4FastSimulationPhysics.hh>
+#include <Shielding.hh>
+
+#include "geometry/Construction.hh"
+#include "physics/Units.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace Physics { ////////////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Physics List Names__________________________________________________________________________
+const std::string _lists = "Shielding MuonTransport EMStandard";
+//----------------------------------------------------------------------------------------------
+
+//__Production Cut Profile Names________________________________________________________________
+const std::string _profiles = "default muon";
+//----------------------------------------------------------------------------------------------
+
+//__Current Physics List________________________________________________________________________
+std::string _list_name = "Shielding";
+std::string _cut_profile = "default";
+G4VModularPhysicsList* _physics_list = nullptr;
+//----------------------------------------------------------------------------------------------
+
+//__Per-Particle Cuts of Current Profile________________________________________________________
+// applied on top of the region cuts, so the profile holds inside every region as well
+std::map<std::string, double> _particle_cuts;
+//----------------------------------------------------------------------------------------------
+
+//__Geant4 Default Production Cut_______________________________________________________________
+constexpr auto _default_cut = 0.7*mm;
+//----------------------------------------------------------------------------------------------
+
+//__Muon Production Cut_________________________________________________________________________
+// secondaries with less than a meter of range are folded into continuous muon energy loss
+constexpr auto _muon_cut = 1*m;
+//----------------------------------------------------------------------------------------------
+
+//__Muon-Nuclear Interaction Physics____________________________________________________________
+class MuonNuclearPhysics : public G4VPhysicsConstructor {
+public:
+  MuonNuclearPhysics() : G4VPhysicsConstructor("MuonNuclear") {}
+  void ConstructParticle() {}
+  void ConstructProcess() {
+    auto process = new G4MuonNuclearProcess;
+    process->RegisterMe(new G4MuonVDNuclearModel);
+    auto helper = G4PhysicsListHelper::GetPhysicsListHelper();
+    helper->RegisterProcess(process, G4MuonPlus::MuonPlus());
+    helper->RegisterProcess(process, G4MuonMinus::MuonMinus());
+  }
+};
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Physics Messenger Directory Path____________________________________________________________
+const std::string Builder::MessengerDirectory = "/physics/";
+//----------------------------------------------------------------------------------------------
+
+//__Physics Simulation Setting Prefix___________________________________________________________
+const std::string Builder::SimSettingPrefix = "PHYSICS";
+//----------------------------------------------------------------------------------------------
+
+//__Builder Constructor_________________________________________________________________________
+Builder::Builder(const std::string& list,
+                 const std::string& cut_profile)
+    : G4UImessenger(MessengerDirectory, "Physics Lists.") {
+  SetList(list);
+  SetCutProfile(cut_profile);
+
+  _list = CreateCommand<Command::NoArg>("list", "List Avaliable Physics Lists.");
+  _list->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _current = CreateCommand<Command::NoArg>("current", "Current Physics List.");
+  _current->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _profile = CreateCommand<Command::StringArg>("cuts/profile", "Select Production Cut Profile.");
+  _profile->SetParameterName("profile", false);
+  _profile->SetDefaultValue("default");
+  _profile->SetCandidates(_profiles.c_str());
+  _profile->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _length = CreateCommand<Command::DoubleUnitArg>("cuts/length", "Set Production Cut for All Particles.");
+  _length->SetParameterName("length", false, false);
+  _length->SetRange("length > 0");
+  _length->SetDefaultUnit("mm");
+  _length->SetUnitCandidates("um mm cm m km");
+  _length->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Builder Messenger Set New Value_____________________________________________________________
+void Builder::SetNewValue(G4UIcommand* command, G4String value) {
+  if (command == _list) {
+    std::cout << "Physics Lists: " << _lists << "\n";
+  } else if (command == _current) {
+    std::cout << "Current Physics List: " << _list_name << " (cuts: " << _cut_profile << ")\n";
+  } else if (command == _profile) {
+    SetCutProfile(value);
+  } else if (command == _length) {
+    SetCutLength(_length->GetNewDoubleValue(value));
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Make Physics List from Name_________________________________________________________________
+G4VModularPhysicsList* Builder::MakeList(const std::string& list) {
+  G4VModularPhysicsList* out;
+  if (list == "MuonTransport") {
+    out = new G4VModularPhysicsList;
+    out->RegisterPhysics(new G4EmStandardPhysics);
+    out->RegisterPhysics(new G4DecayPhysics);
+    out->RegisterPhysics(new MuonNuclearPhysics);
+  } else if (list == "EMStandard") {
+    out = new G4VModularPhysicsList;
+    out->RegisterPhysics(new G4EmStandardPhysics);
+    out->RegisterPhysics(new G4DecayPhysics);
+  } else {
+    if (list != "Shielding")
+      std::cout << "[WARNING] Unknown Physics List \"" << list << "\". Using Shielding.\n";
+    out = new Shielding;
+  }
+  out->RegisterPhysics(new G4StepLimiterPhysics);
+  auto fast_simulation = new G4FastSimulationPhysics;
+  fast_simulation->ActivateFastSimulation("mu-");
+  fast_simulation->ActivateFastSimulation("mu+");
+  out->RegisterPhysics(fast_simulation);
+  out->SetDefaultCutValue(_default_cut);
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Current Physics List____________________________________________________________________
+void Builder::SetList(const std::string& list) {
+  _list_name = (list == "MuonTransport" || list == "EMStandard") ? list : "Shielding";
+  _physics_list = MakeList(list);
+  G4RunManager::GetRunManager()->SetUserInitialization(_physics_list);
+  SetCutProfile(_cut_profile);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Production Cut Profile__________________________________________________________________
+void Builder::SetCutProfile(const std::string& profile) {
+  _particle_cuts.clear();
+  if (profile == "muon") {
+    _cut_profile = profile;
+    for (const auto& particle : {"gamma", "e-", "e+", "proton"})
+      _particle_cuts[particle] = _muon_cut;
+    if (_physics_list) {
+      _physics_list->SetDefaultCutValue(_default_cut);
+      for (const auto& particle : _particle_cuts)
+        _physics_list->SetCutValue(particle.second, particle.first);
+    }
+  } else {
+    if (profile != "default")
+      std::cout << "[WARNING] Unknown Production Cut Profile \"" << profile << "\". Using default.\n";
+    _cut_profile = "default";
+    if (_physics_list)
+      _physics_list->SetDefaultCutValue(_default_cut);
+  }
+  Construction::Builder::UpdateRegions();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Production Cut for All Particles________________________________________________________
+void Builder::SetCutLength(double length) {
+  _cut_profile = Units::to_string(length, Units::Length, Units::LengthString);
+  _particle_cuts.clear();
+  for (const auto& particle : {"gamma", "e-", "e+", "proton"})
+    _particle_cuts[particle] = length;
+  if (_physics_list)
+    _physics_list->SetDefaultCutValue(length);
+  Construction::Builder::UpdateRegions();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Current Physics List Name_______________________________________________________________
+const std::string& Builder::GetListName() {
+  return _list_name;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Current Production Cut Profile__________________________________________________________
+const std::string& Builder::GetCutProfile() {
+  return _cut_profile;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Per-Particle Cuts Overriding Region Cuts________________________________________________
+const std::map<std::string, double>& Builder::GetParticleCuts() {
+  return _particle_cuts;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Physics Specifications______________________________________________________________________
+const Analysis::SimSettingList Builder::GetSpecification() {
+  return Analysis::Settings(SimSettingPrefix,
+    "",      _list_name,
+    "_CUTS", _cut_profile);
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Physics */ //////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
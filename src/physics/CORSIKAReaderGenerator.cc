@@ -125,6 +125,12 @@ namespace { ////////////////////////////////////////////////////////////////////
 G4Mutex _mutex = G4MUTEX_INITIALIZER;
 //----------------------------------------------------------------------------------------------
 
+//__Shower Configuration Loaded by Worker Threads_______________________________________________
+// only workers read the CORSIKA file, so the master reports the shower from here
+CORSIKAConfig _loaded_config{};
+bool _config_loaded = false;
+//----------------------------------------------------------------------------------------------
+
 //__Get Range of Thread in Data_________________________________________________________________
 std::pair<std::size_t, std::size_t> _calculate_thread_range(const std::size_t total) {
   const auto bucket_size = std::ceil(total / static_cast<long double>(G4Threading::GetNumberOfRunningWorkerThreads()));
@@ -405,32 +411,40 @@ void CORSIKAReaderGenerator::SetFile(const std::string& path) {
     G4AutoLock lock(&_mutex);
     _event.clear();
     _collect_source(_path, _particle, _config, _event);
+    _loaded_config = _config;
+    _config_loaded = true;
   }
 }
 //----------------------------------------------------------------------------------------------
 
 //__CORSIKA Reader Generator Specifications_____________________________________________________
 const Analysis::SimSettingList CORSIKAReaderGenerator::GetSpecification() const {
+  auto config = _config;
+  if (!G4Threading::IsWorkerThread()) {
+    G4AutoLock lock(&_mutex);
+    if (_config_loaded)
+      config = _loaded_config;
+  }
   return Analysis::Settings(SimSettingPrefix,
     "",                  _name,
     "_INPUT_FILE",       _path,
-    "_EVENT_ID",         std::to_string(_config.event_id),
-    "_PRIMARY_ENERGY",   std::to_string(_config.energy),
-    "_THETA",            std::to_string(_config.theta),
-    "_PHI",              std::to_string(_config.phi),
-    "_FIRST_HEIGHT",     std::to_string(_config.z0),
-    "_ELECTRON_COUNT",   std::to_string(_config.electron_count),
-    "_MUON_COUNT",       std::to_string(_config.muon_count),
-    "_HADRON_COUNT",     std::to_string(_config.hadron_count),
-    "_PRIMARY_ID",       std::to_string(_config.primary_id.second),
-    "_ENERGY_SLOPE",     std::to_string(_config.energy_slope),
-    "_ENERGY_MIN",       std::to_string(_config.energy_min),
-    "_ENERGY_MAX",       std::to_string(_config.energy_max),
-    "_AZIMUTH_MIN",      std::to_string(_config.azimuth_min),
-    "_AZIMUTH_MAX",      std::to_string(_config.azimuth_max),
-    "_ZENITH_MIN",       std::to_string(_config.zenith_min),
-    "_ZENITH_MAX",       std::to_string(_config.zenith_max),
-    "_MAX_SHIFT_RADIUS", Units::to_string(_config.max_radius, Units::Length, Units::LengthString)
+    "_EVENT_ID",         std::to_string(config.event_id),
+    "_PRIMARY_ENERGY",   std::to_string(config.energy),
+    "_THETA",            std::to_string(config.theta),
+    "_PHI",              std::to_string(config.phi),
+    "_FIRST_HEIGHT",     std::to_string(config.z0),
+    "_ELECTRON_COUNT",   std::to_string(config.electron_count),
+    "_MUON_COUNT",       std::to_string(config.muon_count),
+    "_HADRON_COUNT",     std::to_string(config.hadron_count),
+    "_PRIMARY_ID",       std::to_string(config.primary_id.second),
+    "_ENERGY_SLOPE",     std::to_string(config.energy_slope),
+    "_ENERGY_MIN",       std::to_string(config.energy_min),
+    "_ENERGY_MAX",       std::to_string(config.energy_max),
+    "_AZIMUTH_MIN",      std::to_string(config.azimuth_min),
+    "_AZIMUTH_MAX",      std::to_string(config.azimuth_max),
+    "_ZENITH_MIN",       std::to_string(config.zenith_min),
+    "_ZENITH_MAX",       std::to_string(config.zenith_max),
+    "_MAX_SHIFT_RADIUS", Units::to_string(config.max_radius, Units::Length, Units::LengthString)
   );
 }
 //----------------------------------------------------------------------------------------------
@@ -438,17 +452,8 @@ const Analysis::SimSettingList CORSIKAReaderGenerator::GetSpecification() const
 //__CORSIKA Reader Generator Extra Details______________________________________________________
 const std::vector<std::vector<double>> CORSIKAReaderGenerator::ExtraDetails() const {
   auto out = Tracking::EmptyExtra();
-  out[0].push_back(_config.event_id);
-  out[1].push_back(_translation.first);
-  out[2].push_back(_translation.second);
-  out[3].push_back(_config.energy);
-  out[4].push_back(_config.theta);
-  out[5].push_back(_config.phi);
-  out[6].push_back(_config.z0);
-  out[7].push_back(_config.electron_count);
-  out[8].push_back(_config.muon_count);
-  out[9].push_back(_config.hadron_count);
-  out[10].push_back(_config.primary_id.second);
+  out[0].push_back(_translation.first);
+  out[1].push_back(_translation.second);
   return out;
 }
 //----------------------------------------------------------------------------------------------
@@ -36,6 +36,10 @@ namespace Physics { ////////////////////////////////////////////////////////////
 
 namespace { ////////////////////////////////////////////////////////////////////////////////////
 
+//__Simulation Random Seed______________________________________________________________________
+long _seed{};
+//----------------------------------------------------------------------------------------------
+
 //__Convert Particle Cut Part to String_________________________________________________________
 void _cut_values_to_string(std::string& out,
                            const double min,
@@ -182,6 +186,20 @@ const std::string Generator::MessengerDirectory = "/gen/";
 const std::string Generator::SimSettingPrefix = "GEN";
 //----------------------------------------------------------------------------------------------
 
+//__Set Simulation Random Seed__________________________________________________________________
+// set once from the master before any thread starts, external generators derive their own
+// seeds from it
+void Generator::SetSeed(const long seed) {
+  _seed = seed;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Simulation Random Seed__________________________________________________________________
+long Generator::GetSeed() {
+  return _seed;
+}
+//----------------------------------------------------------------------------------------------
+
 //__Generator Constructor_______________________________________________________________________
 Generator::Generator(const std::string& name,
                      const std::string& description,
@@ -18,91 +18,343 @@
 
 #include "physics/HepMCGenerator.hh"
 
+#ifdef MU__USE_HEPMC3
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <HepMC3/GenEvent.h>
+#include <HepMC3/GenParticle.h>
+#include <HepMC3/GenVertex.h>
+#include <HepMC3/ReaderAscii.h>
+#include <HepMC3/ReaderAsciiHepMC2.h>
+#ifdef MU__USE_HEPMC3_ROOTIO
+#include <HepMC3/ReaderRootTree.h>
+#endif
+
+#include <G4AutoLock.hh>
+#include <G4RunManager.hh>
+#include <G4Threading.hh>
+
+#include "geometry/Earth.hh"
+#include "geometry/Cavern.hh"
 #include "physics/Units.hh"
+#include "util/concurrent.hh"
 
 namespace MATHUSLA { namespace MU {
 
 namespace Physics { ////////////////////////////////////////////////////////////////////////////
 
+//__Shared HepMC Event Stream___________________________________________________________________
+// One reader thread decodes and filters events into a lock-free queue which every worker
+// thread pulls from, so each event in the file is simulated exactly once.
+struct HepMCGenerator::Stream {
+  Stream(const std::string& stream_key,
+         std::unique_ptr<HepMC3::Reader>&& stream_reader,
+         const PropagationList& propagation_list,
+         std::size_t capacity,
+         double z_offset);
+  ~Stream();
+
+  const std::string key;
+  const std::unique_ptr<HepMC3::Reader> reader;
+  const PropagationList propagation;
+  const double offset;
+  util::concurrent::bounded_queue<ParticleVector> queue;
+  std::atomic<bool> stop, finished, exhausted;
+  std::atomic<std::uint_fast64_t> read_count, skip_count;
+  std::thread thread;
+};
+//----------------------------------------------------------------------------------------------
+
 namespace { ////////////////////////////////////////////////////////////////////////////////////
 
-/* FIXME:
+//__Stream Shared Across Worker Threads_________________________________________________________
+std::shared_ptr<HepMCGenerator::Stream> _shared_stream;
+G4Mutex _stream_mutex = G4MUTEX_INITIALIZER;
+//----------------------------------------------------------------------------------------------
+
+//__Check if String Ends with Suffix____________________________________________________________
+bool _ends_with(const std::string& string,
+                const std::string& suffix) {
+  return string.size() >= suffix.size()
+      && string.compare(string.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Open HepMC Reader from File Extension_______________________________________________________
+std::unique_ptr<HepMC3::Reader> _open_reader(const std::string& path) {
+  std::unique_ptr<HepMC3::Reader> out;
+  if (_ends_with(path, ".root")) {
+    #ifdef MU__USE_HEPMC3_ROOTIO
+      out.reset(new HepMC3::ReaderRootTree(path));
+    #else
+      std::cout << "\n[ERROR] HepMC3 Built Without ROOT Support. Cannot Read \"" << path << "\".\n";
+      return nullptr;
+    #endif
+  } else if (_ends_with(path, ".hepmc2")) {
+    out.reset(new HepMC3::ReaderAsciiHepMC2(path));
+  } else {
+    out.reset(new HepMC3::ReaderAscii(path));
+  }
+
+  if (out->failed()) {
+    std::cout << "\n[ERROR] Unable to Open HepMC File \"" << path << "\".\n";
+    return nullptr;
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Convert HepMC Particle to Particle__________________________________________________________
+Particle _convert_particle(const HepMC3::ConstGenParticlePtr& particle,
+                           double offset) {
+  const auto vertex = particle->production_vertex();
+  const auto position = vertex ? vertex->position() : HepMC3::FourVector::ZERO_VECTOR();
+  const auto xz = Cavern::rotate_from_P1(position.z() * mm, -position.x() * mm);
+  Particle out{particle->pid(),
+               position.t() * mm / c_light,
+               static_cast<double>(xz.first),
+               position.y() * mm,
+               static_cast<double>(xz.second + offset)};
+  const auto& momentum = particle->momentum();
+  out.set_pseudo_lorentz_triplet(momentum.pt() * MeV, momentum.eta(), momentum.phi() * rad);
+  return out;
+}
+//----------------------------------------------------------------------------------------------
 
-//__Convert HepMC Four Vector to Geant4 ThreeVector_____________________________________________
-const G4ThreeVector _to_G4ThreeVector(const HepMC::FourVector& vector) {
-  return G4ThreeVector(vector.x(), vector.y(), vector.z());
+//__Convert Final State Particles which Pass Propagation List___________________________________
+ParticleVector _convert_event(const HepMC3::GenEvent& event,
+                              const PropagationList& propagation,
+                              double offset) {
+  ParticleVector out;
+  for (const auto& particle : event.particles()) {
+    if (particle->status() != 1)
+      continue;
+    const auto next = _convert_particle(particle, offset);
+    if (propagation.empty() || InPropagationList(propagation, next))
+      out.push_back(next);
+  }
+  return out;
 }
 //----------------------------------------------------------------------------------------------
 
-//__Add HepMC Particles to Vertex_______________________________________________________________
-void _add_to_vertex(G4PrimaryVertex* vertex,
-                    const PropagationList& propagation,
-                    const std::vector<HepMC::GenParticlePtr>& particles) {
-  for (const auto& particle : particles) {
-    const auto momentum = _to_G4ThreeVector(particle->momentum());
-    // if (InPropagationList(propagation, particle->pid(), momentum)) {
-      vertex->SetPrimary(CreateParticle(particle->pid(), momentum));
-    // }
+//__Read Events into Queue until End of File or Stop____________________________________________
+void _read_events(HepMCGenerator::Stream* stream) {
+  HepMC3::GenEvent event(HepMC3::Units::MEV, HepMC3::Units::MM);
+  while (!stream->stop.load(std::memory_order_relaxed)) {
+    if (!stream->reader->read_event(event) || stream->reader->failed())
+      break;
+    event.set_units(HepMC3::Units::MEV, HepMC3::Units::MM);
+    ++stream->read_count;
+
+    auto particles = _convert_event(event, stream->propagation, stream->offset);
+    if (particles.empty()) {
+      ++stream->skip_count;
+      continue;
+    }
+
+    while (!stream->queue.try_push(std::move(particles))) {
+      if (stream->stop.load(std::memory_order_relaxed))
+        break;
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
   }
+  stream->reader->close();
+  stream->finished.store(true, std::memory_order_release);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Stream Key from Settings____________________________________________________________________
+const std::string _stream_key(const std::string& path,
+                              const PropagationList& propagation,
+                              std::size_t queue_size) {
+  std::string out = path + "|" + std::to_string(queue_size);
+  for (const auto& cut : propagation)
+    out += "|" + GetParticleCutString(cut);
+  return out;
 }
 //----------------------------------------------------------------------------------------------
 
-*/
+//__Get or Start Shared Stream__________________________________________________________________
+std::shared_ptr<HepMCGenerator::Stream> _acquire_stream(const std::string& path,
+                                                        const PropagationList& propagation,
+                                                        std::size_t queue_size) {
+  if (path.empty()) {
+    std::cout << "\n[ERROR] No HepMC File Specified.\n";
+    return nullptr;
+  }
+
+  const auto key = _stream_key(path, propagation, queue_size);
+  G4AutoLock lock(&_stream_mutex);
+  if (_shared_stream && _shared_stream->key == key && !_shared_stream->exhausted.load())
+    return _shared_stream;
+
+  auto reader = _open_reader(path);
+  if (!reader)
+    return nullptr;
+
+  _shared_stream = std::make_shared<HepMCGenerator::Stream>(
+    key, std::move(reader), propagation, queue_size, Earth::TotalShift() + Cavern::IP());
+  return _shared_stream;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Drop Shared Stream from Master Thread_______________________________________________________
+// the master runs each command before the workers, so a file read again starts from its
+// first event instead of reusing the stream of the previous run
+void _release_stream() {
+  if (G4Threading::IsWorkerThread())
+    return;
+  G4AutoLock lock(&_stream_mutex);
+  _shared_stream.reset();
+}
+//----------------------------------------------------------------------------------------------
 
 } /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
-/*
+//__HepMC Stream Constructor____________________________________________________________________
+HepMCGenerator::Stream::Stream(const std::string& stream_key,
+                               std::unique_ptr<HepMC3::Reader>&& stream_reader,
+                               const PropagationList& propagation_list,
+                               std::size_t capacity,
+                               double z_offset)
+    : key(stream_key), reader(std::move(stream_reader)), propagation(propagation_list),
+      offset(z_offset), queue(capacity), stop(false), finished(false), exhausted(false),
+      read_count(0), skip_count(0) {
+  thread = std::thread(_read_events, this);
+}
+//----------------------------------------------------------------------------------------------
+
+//__HepMC Stream Destructor_____________________________________________________________________
+HepMCGenerator::Stream::~Stream() {
+  stop.store(true, std::memory_order_relaxed);
+  if (thread.joinable())
+    thread.join();
+}
+//----------------------------------------------------------------------------------------------
 
 //__HepMC Generator Constructor_________________________________________________________________
-HepMCGenerator::HepMCGenerator(const PropagationList& propagation,
-                               bool unique_events)
-    : Generator("hepmc", "HepMC ROOT Reader"),
-      _reader(nullptr), _propagation_list(propagation), _unique(unique_events) {
-  _read_file = CreateCommand<Command::StringArg>("readFile", "Read HepMC ROOT File.");
+HepMCGenerator::HepMCGenerator(const PropagationList& propagation)
+    : Generator("hepmc", "HepMC3 File Reader Generator."),
+      _propagation_list(propagation), _queue_size(1024UL), _stream_ready(false) {
+  _read_file = CreateCommand<Command::StringArg>("read_file", "Read HepMC3 ASCII or ROOT File.");
   _read_file->SetParameterName("file", false);
   _read_file->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _add_cut = CreateCommand<Command::StringArg>("cuts/add", "Add Cut to HepMC Filter");
+  _add_cut->SetParameterName("cut", false);
+  _add_cut->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _clear_cuts = CreateCommand<Command::NoArg>("cuts/clear", "Clear Cuts from HepMC Filter");
+  _clear_cuts->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_queue_size = CreateCommand<Command::IntegerArg>("queue_size", "Set Number of Prefetched Events.");
+  _ui_queue_size->SetParameterName("queue_size", false);
+  _ui_queue_size->SetRange("queue_size > 0");
+  _ui_queue_size->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 //----------------------------------------------------------------------------------------------
 
-//__Messenger Set Value_________________________________________________________________________
-void HepMCGenerator::SetNewValue(G4UIcommand* command, G4String value) {
-  if (command == _read_file) {
-    if (_reader) {
-      //_reader->close();
-      delete _reader;
+//__Generate Initial Particles__________________________________________________________________
+void HepMCGenerator::GeneratePrimaryVertex(G4Event* event) {
+  if (!_stream_ready) {
+    _stream = _acquire_stream(_path, _propagation_list, _queue_size);
+    _stream_ready = true;
+  }
+
+  _last_event.clear();
+  if (!_stream)
+    return;
+
+  while (!_stream->queue.try_pop(_last_event)) {
+    if (_stream->finished.load(std::memory_order_acquire) && !_stream->queue.try_pop(_last_event)) {
+      if (!_stream->exhausted.exchange(true))
+        std::cout << "\n[WARNING] HepMC File \"" << _path << "\" Exhausted. Aborting Run.\n";
+      G4RunManager::GetRunManager()->AbortRun(true);
+      return;
     }
-    _reader = new HepMC::ReaderAscii(value);
+    std::this_thread::yield();
   }
+
+  for (const auto& particle : _last_event)
+    AddParticle(particle, *event);
 }
 //----------------------------------------------------------------------------------------------
 
-//__Generate Primary Verticies__________________________________________________________________
-void HepMCGenerator::GeneratePrimaryVertex(G4Event* event) {
-  if (_reader && !_reader->failed()) {
-    _reader->read_event(_current_event);
-
-    if (_reader->failed())
-      return;
+//__Get Last Event Data_________________________________________________________________________
+ParticleVector HepMCGenerator::GetLastEvent() const {
+  return _last_event;
+}
+//----------------------------------------------------------------------------------------------
 
-    for (const auto& vertex : _current_event.vertices()) {
-      auto propagated_vertex = DefaultVertex(); // FIXME: is this correct?
-      _add_to_vertex(propagated_vertex, _propagation_list, vertex->particles_in());
-      _add_to_vertex(propagated_vertex, _propagation_list, vertex->particles_out());
-      if (propagated_vertex->GetNumberOfParticle() != 0)
-        event->AddPrimaryVertex(propagated_vertex);
-    }
+//__Messenger Set Value_________________________________________________________________________
+void HepMCGenerator::SetNewValue(G4UIcommand* command,
+                                 G4String value) {
+  if (command == _read_file) {
+    _path = value;
+    _release_stream();
+  } else if (command == _add_cut) {
+    for (const auto& cut : ParsePropagationList(value))
+      _propagation_list.push_back(cut);
+  } else if (command == _clear_cuts) {
+    _propagation_list.clear();
+  } else if (command == _ui_queue_size) {
+    _queue_size = static_cast<std::size_t>(_ui_queue_size->GetNewIntValue(value));
+  } else {
+    Generator::SetNewValue(command, value);
+    return;
   }
+  _stream.reset();
+  _stream_ready = false;
 }
 //----------------------------------------------------------------------------------------------
 
-//__Get PythiaGenerator Specifications__________________________________________________________
-const Analysis::SimSettingList HepMCGenerator::GetSpecification() const {
-  return {};
+//__HepMC Generator Information String__________________________________________________________
+std::ostream& HepMCGenerator::Print(std::ostream& os) const {
+  os << "Generator Info:\n  "
+     << "Name:        " << _name        << "\n  "
+     << "Description: " << _description << "\n  "
+     << "File:        " << _path        << "\n  "
+     << "Queue Size:  " << _queue_size  << "\n  "
+     << "Cuts:        ";
+  for (const auto& cut : _propagation_list)
+    os << "\n    " << cut;
+  return os << "\n";
 }
 //----------------------------------------------------------------------------------------------
 
-*/
+//__HepMCGenerator Specifications_______________________________________________________________
+const Analysis::SimSettingList HepMCGenerator::GetSpecification() const {
+  Analysis::SimSettingList out;
+  out.reserve(4UL + _propagation_list.size());
+  out.emplace_back(SimSettingPrefix, "", _name);
+  out.emplace_back(SimSettingPrefix, "_FILE", _path);
+
+  std::vector<std::string> cut_strings;
+  cut_strings.reserve(_propagation_list.size());
+  for (const auto& cut : _propagation_list)
+    cut_strings.push_back(GetParticleCutString(cut));
+
+  auto cuts = Analysis::IndexedSettings(SimSettingPrefix, "_CUTS_", cut_strings);
+  out.insert(out.cend(),
+             std::make_move_iterator(cuts.begin()),
+             std::make_move_iterator(cuts.end()));
+
+  G4AutoLock lock(&_stream_mutex);
+  const auto stream = _stream ? _stream : _shared_stream;
+  lock.unlock();
+  if (stream) {
+    out.emplace_back(SimSettingPrefix, "_EVENTS_READ", std::to_string(stream->read_count.load()));
+    out.emplace_back(SimSettingPrefix, "_EVENTS_SKIPPED", std::to_string(stream->skip_count.load()));
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
 
 } /* namespace Physics */ //////////////////////////////////////////////////////////////////////
 
 } } /* namespace MATHUSLA::MU */
+
+#endif /* MU__USE_HEPMC3 */
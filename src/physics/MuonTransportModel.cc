@@ -0,0 +1,229 @@
+/*
+ * src/physics/MuonTransportModel.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "physics/MuonTransportModel.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include <G4FastTrack.hh>
+#include <G4FastStep.hh>
+#include <G4MuonPlus.hh>
+#include <G4MuonMinus.hh>
+#include <G4TransportationManager.hh>
+#include <G4GeometryTolerance.hh>
+#include <G4PhysicalConstants.hh>
+#include <Randomize.hh>
+
+#include "physics/Units.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace Physics { ////////////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Largest Fractional Energy Loss per Integration Step_________________________________________
+constexpr auto _max_loss_fraction = 0.05;
+//----------------------------------------------------------------------------------------------
+
+//__Energy Below Which Muons are Considered Stopped_____________________________________________
+constexpr auto _stopping_energy = 10*MeV;
+//----------------------------------------------------------------------------------------------
+
+//__Sample Highland Multiple Scattering Deflection______________________________________________
+const G4ThreeVector _scatter(const G4ThreeVector& direction,
+                             double length,
+                             double energy,
+                             double mass,
+                             const G4Material* material) {
+  const auto t = length / material->GetRadlen();
+  if (t <= 0)
+    return direction;
+
+  const auto momentum = std::sqrt(energy * (energy + 2 * mass));
+  const auto beta = momentum / (energy + mass);
+  const auto theta0 = 13.6*MeV / (beta * momentum) * std::sqrt(t)
+                    * std::max(0.0, 1 + 0.038 * std::log(t / (beta * beta)));
+
+  G4ThreeVector out(std::tan(G4RandGauss::shoot(0, theta0)),
+                    std::tan(G4RandGauss::shoot(0, theta0)),
+                    1);
+  out.rotateUz(direction);
+  return out.unit();
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Fast Muon Messenger Directory Path__________________________________________________________
+const std::string MuonTransportModel::MessengerDirectory = "/physics/fastmuon/";
+//----------------------------------------------------------------------------------------------
+
+//__Muon Transport Model Constructor____________________________________________________________
+MuonTransportModel::MuonTransportModel(G4Region* region)
+    : G4VFastSimulationModel("MuonTransport", region),
+      G4UImessenger(MessengerDirectory, "Fast Muon Transport."),
+      _enabled(false), _max_step(1*m), _min_energy(1*GeV), _straggling(0),
+      _navigator(new G4Navigator) {
+  _calculator.SetVerbose(0);
+
+  _enable = CreateCommand<Command::BoolArg>("enable", "Enable Fast Muon Transport.");
+  _enable->SetParameterName("enable", false);
+  _enable->SetDefaultValue(false);
+  _enable->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_max_step = CreateCommand<Command::DoubleUnitArg>("step", "Set Maximum Transport Step.");
+  _ui_max_step->SetParameterName("step", false, false);
+  _ui_max_step->SetRange("step > 0");
+  _ui_max_step->SetDefaultUnit("m");
+  _ui_max_step->SetUnitCandidates("mm cm m");
+  _ui_max_step->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_min_energy = CreateCommand<Command::DoubleUnitArg>("min_energy", "Set Minimum Energy for Fast Transport.");
+  _ui_min_energy->SetParameterName("energy", false, false);
+  _ui_min_energy->SetRange("energy >= 0");
+  _ui_min_energy->SetDefaultUnit("GeV");
+  _ui_min_energy->SetUnitCandidates("MeV GeV TeV");
+  _ui_min_energy->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_straggling = CreateCommand<Command::DoubleArg>("straggling", "Set Relative Width of Energy Loss.");
+  _ui_straggling->SetParameterName("width", false, false);
+  _ui_straggling->SetRange("width >= 0");
+  _ui_straggling->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Muon Transport Model Destructor_____________________________________________________________
+MuonTransportModel::~MuonTransportModel() {
+  delete _navigator;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Particle is a Muon_________________________________________________________________
+G4bool MuonTransportModel::IsApplicable(const G4ParticleDefinition& particle) {
+  return &particle == G4MuonMinus::Definition() || &particle == G4MuonPlus::Definition();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Muon Should be Fast Transported____________________________________________________
+G4bool MuonTransportModel::ModelTrigger(const G4FastTrack& fast_track) {
+  return _enabled && fast_track.GetPrimaryTrack()->GetKineticEnergy() > _min_energy;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Transport Muon to Region Boundary___________________________________________________________
+void MuonTransportModel::DoIt(const G4FastTrack& fast_track,
+                              G4FastStep& fast_step) {
+  const auto track = fast_track.GetPrimaryTrack();
+  const auto particle = track->GetParticleDefinition();
+  const auto mass = particle->GetPDGMass();
+  const auto region = fast_track.GetEnvelope();
+  const auto tolerance = G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+
+  const auto world = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
+  if (_navigator->GetWorldVolume() != world)
+    _navigator->SetWorldVolume(world);
+
+  auto position = track->GetPosition();
+  auto direction = track->GetMomentumDirection();
+  auto energy = track->GetKineticEnergy();
+  auto time = track->GetGlobalTime();
+  auto path = 0.0;
+  auto deposit = 0.0;
+
+  auto volume = _navigator->LocateGlobalPointAndSetup(position, &direction, false, false);
+  while (volume && volume->GetLogicalVolume()->GetRegion() == region) {
+    const auto material = volume->GetLogicalVolume()->GetMaterial();
+    auto safety = 0.0;
+    const auto boundary = _navigator->ComputeStep(position, direction, _max_step, safety);
+    const auto length = std::max(tolerance, std::min(boundary, _max_step));
+
+    const auto before = energy;
+    energy = _lose_energy(energy, length, particle, material);
+    if (energy <= 0) {
+      fast_step.KillPrimaryTrack();
+      fast_step.ProposeTotalEnergyDeposited(deposit + before);
+      return;
+    }
+
+    const auto average = 0.5 * (before + energy);
+    time += length / (c_light * std::sqrt(average * (average + 2 * mass)) / (average + mass));
+    path += length;
+    deposit += before - energy;
+    position += length * direction;
+    direction = _scatter(direction, length, average, mass, material);
+
+    if (boundary <= _max_step)
+      _navigator->SetGeometricallyLimitedStep();
+    volume = _navigator->LocateGlobalPointAndSetup(position, &direction, true);
+  }
+
+  fast_step.ProposePrimaryTrackFinalPosition(position, false);
+  fast_step.ProposePrimaryTrackFinalTime(time);
+  fast_step.ProposePrimaryTrackFinalKineticEnergyAndDirection(energy, direction, false);
+  fast_step.ProposePrimaryTrackPathLength(path);
+  fast_step.ProposeTotalEnergyDeposited(deposit);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Muon Transport Messenger Set New Value______________________________________________________
+void MuonTransportModel::SetNewValue(G4UIcommand* command, G4String value) {
+  if (command == _enable) {
+    _enabled = _enable->GetNewBoolValue(value);
+  } else if (command == _ui_max_step) {
+    _max_step = _ui_max_step->GetNewDoubleValue(value);
+  } else if (command == _ui_min_energy) {
+    _min_energy = _ui_min_energy->GetNewDoubleValue(value);
+  } else if (command == _ui_straggling) {
+    _straggling = _ui_straggling->GetNewDoubleValue(value);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Integrate Energy Loss over Step_____________________________________________________________
+// integrates the unrestricted stopping power, which includes the mean radiative losses, and
+// smears the result with a gaussian of relative width _straggling
+double MuonTransportModel::_lose_energy(double energy,
+                                        double length,
+                                        const G4ParticleDefinition* particle,
+                                        const G4Material* material) {
+  const auto initial = energy;
+  auto remaining = length;
+  while (remaining > 0 && energy > _stopping_energy) {
+    const auto dedx = _calculator.ComputeTotalDEDX(energy, particle, material);
+    if (dedx <= 0)
+      break;
+    const auto step = std::min(remaining, _max_loss_fraction * energy / dedx);
+    energy -= dedx * step;
+    remaining -= step;
+  }
+  if (energy <= _stopping_energy)
+    return 0;
+
+  if (_straggling > 0) {
+    const auto loss = (initial - energy) * std::max(0.0, G4RandGauss::shoot(1, _straggling));
+    energy = initial - loss;
+  }
+  return energy > _stopping_energy ? energy : 0;
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Physics */ //////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
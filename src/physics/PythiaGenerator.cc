@@ -18,6 +18,10 @@
 
 #include "physics/PythiaGenerator.hh"
 
+#include <atomic>
+
+#include <G4Threading.hh>
+
 #include <Pythia8/ParticleData.h>
 
 #include "geometry/Earth.hh"
@@ -35,6 +39,21 @@ G4ThreadLocal std::vector<std::string>* PythiaGenerator::_pythia_settings = null
 G4ThreadLocal bool PythiaGenerator::_settings_on = false;
 //----------------------------------------------------------------------------------------------
 
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Events Generated Across All Threads_________________________________________________________
+std::atomic<std::uint_fast64_t> _counter{0ULL};
+//----------------------------------------------------------------------------------------------
+
+//__Reset Event Counter from Master Thread______________________________________________________
+void _reset_counter() {
+  if (!G4Threading::IsWorkerThread())
+    _counter = 0ULL;
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
 //__Pythia Generator Construction_______________________________________________________________
 PythiaGenerator::PythiaGenerator(const PropagationList& propagation,
                                  Pythia8::Pythia* pythia)
@@ -93,10 +112,19 @@ PythiaGenerator::PythiaGenerator(const std::string& path) : PythiaGenerator({},
 
 namespace { ////////////////////////////////////////////////////////////////////////////////////
 
+//__Pythia Objects Built on this Thread_________________________________________________________
+G4ThreadLocal std::uint_fast64_t _builds{};
+//----------------------------------------------------------------------------------------------
+
 //__Setup Pythia Randomness_____________________________________________________________________
+// the seed follows the simulation seed, and differs between threads and between rebuilds so no
+// two Pythia objects repeat the same events, Pythia accepts seeds up to 900000000
 Pythia8::Pythia* _setup_random(Pythia8::Pythia* pythia) {
+  const auto thread = static_cast<std::uint_fast64_t>(G4Threading::G4GetThreadId() + 1);
+  const auto seed = static_cast<std::uint_fast64_t>(Generator::GetSeed())
+                  + 1000003ULL * thread + 7919ULL * _builds++;
   pythia->readString("Random:setSeed = on");
-  pythia->readString("Random:seed = 0");
+  pythia->readString("Random:seed = " + std::to_string(1ULL + seed % 899999999ULL));
   return pythia;
 }
 //----------------------------------------------------------------------------------------------
@@ -113,13 +141,17 @@ Pythia8::Pythia* _reconstruct_pythia(Pythia8::Pythia* pythia) {
 }
 //----------------------------------------------------------------------------------------------
 
-//__Create Pythia from Settings_________________________________________________________________
-Pythia8::Pythia* _create_pythia(std::vector<std::string>* settings,
+//__Create Pythia from File and Settings________________________________________________________
+// the settings are read after the file and after the seed, so they can override either
+Pythia8::Pythia* _create_pythia(const std::string& path,
+                                const std::vector<std::string>& settings,
                                 bool& settings_on) {
   auto pythia = new Pythia8::Pythia();
-  for (const auto& setting : *settings)
-    pythia->readString(setting);
+  if (!path.empty())
+    pythia->readFile(path);
   _setup_random(pythia);
+  for (const auto& setting : settings)
+    pythia->readString(setting);
   pythia->init();
   settings_on = true;
   return pythia;
@@ -174,10 +206,12 @@ ParticleVector _convert_pythia_event(Pythia8::Pythia* pythia,
 
 //__Generate Initial Particles__________________________________________________________________
 void PythiaGenerator::GeneratePrimaryVertex(G4Event* event) {
-  if (!_settings_on && !_pythia_settings->empty()) {
-    _pythia = _create_pythia(_pythia_settings, _settings_on);
+  if (!_settings_on && (!_path.empty() || !_pythia_settings->empty())) {
+    delete _pythia;
+    _pythia = _create_pythia(_path, *_pythia_settings, _settings_on);
   } else if (!_pythia) {
     std::cout << "\n[ERROR] No Pythia Configuration Specified.\n";
+    return;
   }
 
   ++_counter;
@@ -207,7 +241,7 @@ void PythiaGenerator::SetNewValue(G4UIcommand* command,
                                   G4String value) {
   if (command == _read_string) {
     _pythia_settings->push_back(value);
-    _settings_on = true;
+    _settings_on = false;
   } else if (command == _read_file) {
     SetPythia(value);
   } else if (command == _add_cut) {
@@ -227,42 +261,48 @@ void PythiaGenerator::SetNewValue(G4UIcommand* command,
 void PythiaGenerator::SetPythia(Pythia8::Pythia* pythia) {
   if (!pythia)
     return;
-  _counter = 0ULL;
+  _reset_counter();
   _pythia_settings->clear();
+  _path.clear();
   _settings_on = false;
+  const auto previous = _pythia;
   _pythia = _reconstruct_pythia(pythia);
   _pythia->init();
+  if (previous != pythia)
+    delete previous;
 }
 //----------------------------------------------------------------------------------------------
 
 //__Set Pythia Object from Settings_____________________________________________________________
 void PythiaGenerator::SetPythia(const std::vector<std::string>& settings) {
   *_pythia_settings = settings;
-  _counter = 0ULL;
-  _pythia = _create_pythia(_pythia_settings, _settings_on);
+  _path.clear();
+  _reset_counter();
+  _settings_on = false;
 }
 //----------------------------------------------------------------------------------------------
 
-//__Set Pythia Object from Settings_____________________________________________________________
+//__Set Pythia Object from File_________________________________________________________________
+// like the settings, the file is only read when the first event is generated on a worker, and
+// strings read afterwards are applied on top of it
 void PythiaGenerator::SetPythia(const std::string& path) {
-  _counter = 0ULL;
+  _reset_counter();
   _pythia_settings->clear();
   _settings_on = false;
   _path = path;
-  _pythia = new Pythia8::Pythia();
-  _pythia->readFile(_path);
-  _setup_random(_pythia);
-  _pythia->init();
 }
 //----------------------------------------------------------------------------------------------
 
 //__PythiaGenerator Specifications______________________________________________________________
 const Analysis::SimSettingList PythiaGenerator::GetSpecification() const {
   Analysis::SimSettingList config;
-  if (_path.empty() && !_pythia_settings->empty()) {
-    config = Analysis::IndexedSettings(SimSettingPrefix, "_SETTING_", *_pythia_settings);
-  } else if (!_path.empty()) {
+  if (!_path.empty())
     config.emplace_back(SimSettingPrefix, "_CONFIG", _path);
+  if (!_pythia_settings->empty()) {
+    auto settings = Analysis::IndexedSettings(SimSettingPrefix, "_SETTING_", *_pythia_settings);
+    config.insert(config.cend(),
+                  std::make_move_iterator(settings.begin()),
+                  std::make_move_iterator(settings.end()));
   }
 
   config.emplace_back(SimSettingPrefix, "_PROCESS", _process_string);
@@ -283,7 +323,7 @@ const Analysis::SimSettingList PythiaGenerator::GetSpecification() const {
   out.insert(out.cend(),
              std::make_move_iterator(cuts.begin()),
              std::make_move_iterator(cuts.end()));
-  out.emplace_back(SimSettingPrefix, "_EVENTS", std::to_string(_counter));
+  out.emplace_back(SimSettingPrefix, "_EVENTS", std::to_string(_counter.load()));
 
   return out;
 }
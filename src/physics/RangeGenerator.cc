@@ -18,6 +18,7 @@
 
 #include "physics/Generator.hh"
 
+#include <algorithm>
 #include <ostream>
 
 #include <Randomize.hh>
@@ -43,7 +44,8 @@ RangeGenerator::RangeGenerator(const std::string& name,
                                const std::string& description,
                                const Particle& min,
                                const Particle& max)
-    : Generator(name, description, min), _min(min), _max(max) {
+    : Generator(name, description, min), _min(min), _max(max),
+      _multiplicity(1UL), _batch_size(1024UL), _sample_index(0UL) {
   GenerateCommands();
 }
 //----------------------------------------------------------------------------------------------
@@ -97,33 +99,97 @@ void RangeGenerator::GenerateCommands() {
   _ui_ke_max->SetDefaultUnit("GeV");
   _ui_ke_max->SetUnitCandidates("eV keV MeV GeV");
   _ui_ke_max->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_multiplicity = CreateCommand<Command::IntegerArg>("multiplicity", "Set Number of Particles per Event.");
+  _ui_multiplicity->SetParameterName("multiplicity", false);
+  _ui_multiplicity->SetRange("multiplicity > 0");
+  _ui_multiplicity->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_batch_size = CreateCommand<Command::IntegerArg>("batch_size", "Set Number of Particles Sampled per Batch.");
+  _ui_batch_size->SetParameterName("batch_size", false);
+  _ui_batch_size->SetRange("batch_size > 0");
+  _ui_batch_size->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Draw Kinematics for Next Batch of Particles_________________________________________________
+void RangeGenerator::FillSampleBuffer(std::size_t count) {
+  _eta_samples.resize(count);
+  _phi_samples.resize(count);
+  _energy_samples.resize(count);
+
+  const auto size = static_cast<int>(count);
+  auto engine = G4Random::getTheEngine();
+  engine->flatArray(size, _eta_samples.data());
+  engine->flatArray(size, _phi_samples.data());
+  engine->flatArray(size, _energy_samples.data());
+
+  const auto eta_min = _min.eta();
+  const auto eta_width = _max.eta() - eta_min;
+  const auto phi_min = _min.phi();
+  const auto phi_width = _max.phi() - phi_min;
+  const auto energy_min = _using_range_ke ? _min.ke() : _min.pT();
+  const auto energy_width = (_using_range_ke ? _max.ke() : _max.pT()) - energy_min;
+
+  for (std::size_t i{}; i < count; ++i)
+    _eta_samples[i] = eta_min + eta_width * _eta_samples[i];
+  for (std::size_t i{}; i < count; ++i)
+    _phi_samples[i] = phi_min + phi_width * _phi_samples[i];
+  for (std::size_t i{}; i < count; ++i)
+    _energy_samples[i] = energy_min + energy_width * _energy_samples[i];
+
+  _sample_index = 0;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Discard Pre-Drawn Kinematics________________________________________________________________
+void RangeGenerator::ResetSampleBuffer() {
+  _sample_index = _eta_samples.size();
 }
 //----------------------------------------------------------------------------------------------
 
 //__Generate Initial Particles__________________________________________________________________
+// batches never outlive the event, so its kinematics only come from its own engine state and do
+// not depend on which thread ran the events before it
 void RangeGenerator::GeneratePrimaryVertex(G4Event* event) {
-  const auto eta = G4RandFlat::shoot(_min.eta(), _max.eta());
-  const auto phi = G4RandFlat::shoot(_min.phi(), _max.phi());
-  if (_using_range_ke) {
-    _particle.set_pseudo_lorentz_triplet(1, eta, phi);
-    _particle.set_ke(G4RandFlat::shoot(_min.ke(), _max.ke()));
-  } else {
-    _particle.set_pseudo_lorentz_triplet(G4RandFlat::shoot(_min.pT(), _max.pT()), eta, phi);
+  _last_event.clear();
+  _last_event.reserve(_multiplicity);
+  ResetSampleBuffer();
+  for (std::size_t i{}; i < _multiplicity; ++i) {
+    if (_sample_index >= _eta_samples.size())
+      FillSampleBuffer(std::min(_batch_size, _multiplicity - i));
+
+    const auto eta = _eta_samples[_sample_index];
+    const auto phi = _phi_samples[_sample_index];
+    const auto energy = _energy_samples[_sample_index];
+    ++_sample_index;
+
+    if (_using_range_ke) {
+      _particle.set_pseudo_lorentz_triplet(1, eta, phi);
+      _particle.set_ke(energy);
+    } else {
+      _particle.set_pseudo_lorentz_triplet(energy, eta, phi);
+    }
+    AddParticle(_particle, *event);
+    _last_event.push_back(_particle);
   }
-  AddParticle(_particle, *event);
 }
 //----------------------------------------------------------------------------------------------
 
 //__Get Last Event Data_________________________________________________________________________
 ParticleVector RangeGenerator::GetLastEvent() const {
-  return ParticleVector{};
+  return _last_event;
 }
 //----------------------------------------------------------------------------------------------
 
 //__Range Generator Messenger Set Value_________________________________________________________
 void RangeGenerator::SetNewValue(G4UIcommand* command,
                                  G4String value) {
-  if (command == _ui_id) {
+  if (command == _ui_multiplicity) {
+    _multiplicity = static_cast<std::size_t>(_ui_multiplicity->GetNewIntValue(value));
+  } else if (command == _ui_batch_size) {
+    _batch_size = static_cast<std::size_t>(_ui_batch_size->GetNewIntValue(value));
+  } else if (command == _ui_id) {
     _particle.id = _ui_id->GetNewIntValue(value);
     _min.id = _particle.id;
     _max.id = _particle.id;
@@ -191,7 +257,8 @@ std::ostream& RangeGenerator::Print(std::ostream& os) const {
   os << "Generator Info:\n  "
      << "Name:        " << _name        << "\n  "
      << "Description: " << _description << "\n  "
-     << "Particle ID: " << _particle.id << "\n  ";
+     << "Particle ID: " << _particle.id << "\n  "
+     << "Multiplicity: " << _multiplicity << "\n  ";
 
   if (_using_range_ke) {
     os << "avg ke:      " << G4BestUnit(0.5 * (_min.ke() + _max.ke()), "Energy") << "\n    "
@@ -222,6 +289,7 @@ const Analysis::SimSettingList RangeGenerator::GetSpecification() const {
   return Analysis::Settings(SimSettingPrefix,
     "",         _name,
     "_PDG_ID",  std::to_string(_particle.id),
+    "_MULTIPLICITY", std::to_string(_multiplicity),
     (_using_range_ke ? "_KE_MIN" : "_PT_MIN"),
     (_using_range_ke ? std::to_string(_min.ke() / Units::Energy)   + " " + Units::EnergyString
                      : std::to_string(_min.pT() / Units::Momentum) + " " + Units::MomentumString),
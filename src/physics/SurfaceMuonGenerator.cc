@@ -0,0 +1,287 @@
+/*
+ * src/physics/SurfaceMuonGenerator.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "physics/SurfaceMuonGenerator.hh"
+
+#include <atomic>
+#include <cmath>
+
+#include <G4RunManager.hh>
+#include <G4PhysicalConstants.hh>
+#include <Randomize.hh>
+#include <tls.hh>
+
+#include "physics/Units.hh"
+
+namespace MATHUSLA { namespace MU {
+
+namespace Physics { ////////////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Gaisser Sea-Level Muon Flux Parameters______________________________________________________
+constexpr auto _spectral_index = 2.7;
+constexpr auto _pion_energy    = 115*GeV;
+constexpr auto _kaon_energy    = 850*GeV;
+constexpr auto _kaon_fraction  = 0.054;
+//----------------------------------------------------------------------------------------------
+
+//__Sea-Level Muon Charge Ratio_________________________________________________________________
+constexpr auto _mu_plus_fraction = 1.27 / 2.27;
+//----------------------------------------------------------------------------------------------
+
+//__Maximum Sampling Attempts per Event_________________________________________________________
+constexpr std::size_t _max_attempts = 10000000UL;
+//----------------------------------------------------------------------------------------------
+
+//__Sampling Counters Shared Across Threads_____________________________________________________
+std::atomic<std::uint_fast64_t> _sampled{};
+std::atomic<std::uint_fast64_t> _survived{};
+//----------------------------------------------------------------------------------------------
+
+//__Sample Power Law Energy_____________________________________________________________________
+double _power_law(double min,
+                  double max,
+                  double u) {
+  const auto exponent = 1 - _spectral_index;
+  const auto low = std::pow(min, exponent);
+  return std::pow(low + u * (std::pow(max, exponent) - low), 1 / exponent);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Gaisser Angular Factor Relative to Power Law________________________________________________
+double _gaisser_factor(double energy,
+                       double cos_zenith) {
+  return 1 / (1 + 1.1 * energy * cos_zenith / _pion_energy)
+       + _kaon_fraction / (1 + 1.1 * energy * cos_zenith / _kaon_energy);
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Surface Muon Generator Constructor__________________________________________________________
+SurfaceMuonGenerator::SurfaceMuonGenerator(const std::string& name,
+                                           const std::string& description,
+                                           const Particle& vertex)
+    : Generator(name, description, vertex),
+      _depth(-1), _ke_min(0), _ke_max(0), _zenith_max(0), _size(0) {
+  GenerateCommands();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Generate UI Commands________________________________________________________________________
+void SurfaceMuonGenerator::GenerateCommands() {
+  _ui_table = CreateCommand<Command::StringArg>("table", "Read Survival Table.");
+  _ui_table->SetParameterName("path", false);
+  _ui_table->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_depth = CreateCommand<Command::DoubleUnitArg>("depth", "Set Vertical Rock Depth.");
+  _ui_depth->SetParameterName("depth", false, false);
+  _ui_depth->SetRange("depth >= 0");
+  _ui_depth->SetDefaultUnit("m");
+  _ui_depth->SetUnitCandidates("cm m km");
+  _ui_depth->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_ke_min = CreateCommand<Command::DoubleUnitArg>("ke_min", "Set Minimum Sea-Level Kinetic Energy.");
+  _ui_ke_min->SetParameterName("ke_min", false, false);
+  _ui_ke_min->SetRange("ke_min > 0");
+  _ui_ke_min->SetDefaultUnit("GeV");
+  _ui_ke_min->SetUnitCandidates("MeV GeV TeV");
+  _ui_ke_min->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_ke_max = CreateCommand<Command::DoubleUnitArg>("ke_max", "Set Maximum Sea-Level Kinetic Energy.");
+  _ui_ke_max->SetParameterName("ke_max", false, false);
+  _ui_ke_max->SetRange("ke_max > 0");
+  _ui_ke_max->SetDefaultUnit("GeV");
+  _ui_ke_max->SetUnitCandidates("MeV GeV TeV");
+  _ui_ke_max->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_zenith_max = CreateCommand<Command::DoubleUnitArg>("zenith_max", "Set Maximum Zenith Angle.");
+  _ui_zenith_max->SetParameterName("zenith_max", false, false);
+  _ui_zenith_max->SetRange("zenith_max >= 0");
+  _ui_zenith_max->SetDefaultUnit("deg");
+  _ui_zenith_max->SetUnitCandidates("degree deg radian rad milliradian mrad");
+  _ui_zenith_max->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  _ui_size = CreateCommand<Command::DoubleUnitArg>("size", "Set Side Length of Square Vertex Area.");
+  _ui_size->SetParameterName("size", false, false);
+  _ui_size->SetRange("size >= 0");
+  _ui_size->SetDefaultUnit("m");
+  _ui_size->SetUnitCandidates("cm m km");
+  _ui_size->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Generate Initial Particles__________________________________________________________________
+void SurfaceMuonGenerator::GeneratePrimaryVertex(G4Event* event) {
+  _last_event.clear();
+  if (_table.empty()) {
+    std::cout << "\n[WARNING] No Survival Table for \"" << _name << "\" Generator. Aborting Run.\n";
+    G4RunManager::GetRunManager()->AbortRun(true);
+    return;
+  }
+
+  const auto depth = _depth_or_default() / m;
+  const auto ke_min = _ke_min_or_default();
+  const auto ke_max = _ke_max_or_default();
+  const auto cos_min = _cos_zenith_max_or_default();
+  const auto flat = [] { return G4UniformRand(); };
+
+  // the attempts are counted locally and published once per event, so the workers do not share
+  // a counter inside the sampling loop
+  for (std::size_t attempt{}; attempt < _max_attempts; ++attempt) {
+    const auto energy = _power_law(ke_min, ke_max, G4UniformRand());
+    const auto cos_zenith = std::sqrt(cos_min * cos_min + G4UniformRand() * (1 - cos_min * cos_min));
+    if (G4UniformRand() * (1 + _kaon_fraction) >= _gaisser_factor(energy, cos_zenith))
+      continue;
+
+    const auto final_energy = _table.sample(energy / GeV, cos_zenith, depth, flat) * GeV;
+    if (final_energy <= 0)
+      continue;
+    _sampled.fetch_add(attempt + 1, std::memory_order_relaxed);
+    _survived.fetch_add(1, std::memory_order_relaxed);
+
+    const auto sin_zenith = std::sqrt(1 - cos_zenith * cos_zenith);
+    const auto azimuth = twopi * G4UniformRand();
+
+    Particle muon(G4UniformRand() < _mu_plus_fraction ? -13 : 13);
+    muon.set_vertex(_particle.t,
+                    _particle.x + _size * (G4UniformRand() - 0.5),
+                    _particle.y + _size * (G4UniformRand() - 0.5),
+                    _particle.z);
+    muon.set_p_unit(sin_zenith * std::cos(azimuth), sin_zenith * std::sin(azimuth), cos_zenith);
+    muon.set_ke(final_energy);
+
+    AddParticle(muon, *event);
+    _last_event.push_back(muon);
+    return;
+  }
+
+  _sampled.fetch_add(_max_attempts, std::memory_order_relaxed);
+  std::cout << "\n[WARNING] No Muons Survived " << _max_attempts << " Attempts. Aborting Run.\n";
+  G4RunManager::GetRunManager()->AbortRun(true);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Last Event Data_________________________________________________________________________
+ParticleVector SurfaceMuonGenerator::GetLastEvent() const {
+  return _last_event;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Surface Muon Generator Messenger Set Value__________________________________________________
+void SurfaceMuonGenerator::SetNewValue(G4UIcommand* command,
+                                       G4String value) {
+  if (command == _ui_table) {
+    _path = value;
+    if (!_table.read(_path))
+      std::cout << "[WARNING] Unable to Read Survival Table \"" << _path << "\".\n";
+  } else if (command == _ui_depth) {
+    _depth = _ui_depth->GetNewDoubleValue(value);
+  } else if (command == _ui_ke_min) {
+    _ke_min = _ui_ke_min->GetNewDoubleValue(value);
+  } else if (command == _ui_ke_max) {
+    _ke_max = _ui_ke_max->GetNewDoubleValue(value);
+  } else if (command == _ui_zenith_max) {
+    _zenith_max = _ui_zenith_max->GetNewDoubleValue(value);
+  } else if (command == _ui_size) {
+    _size = _ui_size->GetNewDoubleValue(value);
+  } else {
+    Generator::SetNewValue(command, value);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Surface Muon Generator Information String___________________________________________________
+std::ostream& SurfaceMuonGenerator::Print(std::ostream& os) const {
+  os << "Generator Info:\n  "
+     << "Name:        " << _name        << "\n  "
+     << "Description: " << _description << "\n  "
+     << "Table:       " << (_path.empty() ? "(none)" : _path) << "\n  ";
+  if (!_table.empty()) {
+    os << "depth:       " << G4BestUnit(_depth_or_default(), "Length")         << "\n  "
+       << "ke min:      " << G4BestUnit(_ke_min_or_default(), "Energy")        << "\n  "
+       << "ke max:      " << G4BestUnit(_ke_max_or_default(), "Energy")        << "\n  "
+       << "zenith max:  " << G4BestUnit(std::acos(_cos_zenith_max_or_default()), "Angle") << "\n  ";
+  }
+  os << "size:        " << G4BestUnit(_size, "Length") << "\n  "
+     << "vertex:      (" << G4BestUnit(_particle.t, "Time")   << ", "
+                         << G4BestUnit(_particle.x, "Length") << ", "
+                         << G4BestUnit(_particle.y, "Length") << ", "
+                         << G4BestUnit(_particle.z, "Length") << ")\n";
+  return os;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Reset Sampling Counters_____________________________________________________________________
+// called by the master at the start of each run so _SURVIVAL only covers that run
+void SurfaceMuonGenerator::ResetCounters() {
+  _sampled.store(0, std::memory_order_relaxed);
+  _survived.store(0, std::memory_order_relaxed);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Surface Muon Generator Specifications_______________________________________________________
+const Analysis::SimSettingList SurfaceMuonGenerator::GetSpecification() const {
+  const auto sampled = _sampled.load(std::memory_order_relaxed);
+  const auto survived = _survived.load(std::memory_order_relaxed);
+  return Analysis::Settings(SimSettingPrefix,
+    "",            _name,
+    "_TABLE",      _path,
+    "_DEPTH",      std::to_string(_depth_or_default() / Units::Length) + " " + Units::LengthString,
+    "_KE_MIN",     std::to_string(_ke_min_or_default() / Units::Energy) + " " + Units::EnergyString,
+    "_KE_MAX",     std::to_string(_ke_max_or_default() / Units::Energy) + " " + Units::EnergyString,
+    "_ZENITH_MAX", std::to_string(std::acos(_cos_zenith_max_or_default()) / Units::Angle) + " " + Units::AngleString,
+    "_SIZE",       std::to_string(_size / Units::Length) + " " + Units::LengthString,
+    "_SURVIVAL",   std::to_string(sampled ? static_cast<double>(survived) / sampled : 0.0),
+    "_VERTEX", "(" + std::to_string(_particle.t / Units::Time)   + ", "
+                   + std::to_string(_particle.x / Units::Length) + ", "
+                   + std::to_string(_particle.y / Units::Length) + ", "
+                   + std::to_string(_particle.z / Units::Length) + ")");
+}
+//----------------------------------------------------------------------------------------------
+
+//__Depth Defaulting to Shallowest Table Depth__________________________________________________
+double SurfaceMuonGenerator::_depth_or_default() const {
+  return _depth >= 0 || _table.empty() ? _depth : _table.depths().front() * m;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Minimum Energy Defaulting to Table Range____________________________________________________
+double SurfaceMuonGenerator::_ke_min_or_default() const {
+  return _ke_min > 0 || _table.empty() ? _ke_min : _table.energies().front() * GeV;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Maximum Energy Defaulting to Table Range____________________________________________________
+double SurfaceMuonGenerator::_ke_max_or_default() const {
+  return _ke_max > 0 || _table.empty() ? _ke_max : _table.energies().back() * GeV;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Cosine of Maximum Zenith Angle Defaulting to Table Range____________________________________
+double SurfaceMuonGenerator::_cos_zenith_max_or_default() const {
+  if (_zenith_max > 0)
+    return std::cos(_zenith_max);
+  return _table.empty() ? 0.0 : std::max(0.0, _table.cos_zeniths().front());
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Physics */ //////////////////////////////////////////////////////////////////////
+
+} } /* namespace MATHUSLA::MU */
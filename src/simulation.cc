@@ -15,9 +15,15 @@
  * limitations under the License.
  */
 
+#include <chrono>
+#include <fstream>
+
+#include <sys/resource.h>
+
 #include <G4MTRunManager.hh>
-#include <Shielding.hh>
-#include <G4StepLimiterPhysics.hh>
+#ifdef MU__USE_G4TASKING
+#include <G4TaskRunManager.hh>
+#endif
 #include <G4UIExecutive.hh>
 #include <G4VisExecutive.hh>
 #include <tls.hh>
@@ -25,14 +31,52 @@
 #include "action.hh"
 #include "geometry/Construction.hh"
 #include "geometry/Earth.hh"
+#include "physics/Builder.hh"
 #include "physics/Units.hh"
+#include "tracking.hh"
 #include "ui.hh"
 
 #include "util/command_line_parser.hh"
 #include "util/error.hh"
+#include "util/thread.hh"
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Write Benchmark Report as JSON______________________________________________________________
+void _write_benchmark(const std::string& path,
+                      double startup_time) {
+  using namespace MATHUSLA::MU;
+  const auto summary = RunAction::GetSummary();
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  const auto bytes_per_event = summary.events ? summary.output_bytes / static_cast<double>(summary.events)
+                                             : 0.0;
+
+  std::ofstream file(path);
+  file << "{\"startup_s\":" << startup_time
+       << ",\"runs\":" << summary.runs
+       << ",\"events\":" << summary.events
+       << ",\"run_s\":" << summary.run_time
+       << ",\"events_per_s\":" << (summary.run_time > 0 ? summary.events / summary.run_time : 0.0)
+       << ",\"merge_s\":" << summary.merge_time
+       << ",\"peak_rss_kb\":" << usage.ru_maxrss
+       << ",\"output_bytes\":" << summary.output_bytes
+       << ",\"bytes_per_event\":" << bytes_per_event
+       << ",\"steps\":" << summary.steps
+       << ",\"ns_per_step\":" << (summary.steps ? 1e9 * summary.step_time / summary.steps : 0.0)
+       << "}\n";
+  if (!file)
+    std::cout << "[WARNING] Unable to Write Benchmark Report \"" << path << "\".\n";
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
 
 //__Main Function: Simulation___________________________________________________________________
 int main(int argc, char* argv[]) {
+  const auto start_time = std::chrono::steady_clock::now();
   using namespace MATHUSLA;
   using namespace MATHUSLA::MU;
 
@@ -41,6 +85,7 @@ int main(int argc, char* argv[]) {
   option help_opt    ('h', "help",     "MATHUSLA Muon Simulation",  option::no_arguments);
   option gen_opt     ('g', "gen",      "Generator",                 option::required_arguments);
   option det_opt     ('d', "det",      "Detector",                  option::required_arguments);
+  option physics_opt (0,   "physics",  "Physics List",              option::required_arguments);
   option shift_opt   (0,   "shift",    "Shift Last Earth Layer",    option::required_arguments);
   option data_opt    ('o' ,"out",      "Data Output Directory",     option::required_arguments);
   option export_opt  ('E', "export",   "Export Output Directory",   option::required_arguments);
@@ -50,14 +95,36 @@ int main(int argc, char* argv[]) {
   option vis_opt     ('v', "vis",      "Visualization",             option::no_arguments);
   option quiet_opt   ('q', "quiet",    "Quiet Mode",                option::no_arguments);
   option thread_opt  ('j', "threads",
-    "Multi-Threading Mode: Specify Optional number of threads (default: 2)",
+    "Multi-Threading Mode: Specify Optional number of threads or \"auto\" (default: 2)",
+    option::optional_arguments);
+  option pin_opt     (0,   "pin",
+    "Pin Worker Threads: Specify Optional mode \"core\" or \"numa\" (default: core)",
     option::optional_arguments);
+  option task_opt    (0,   "tasking",  "Task-Based Run Manager",    option::no_arguments);
+  option grain_opt   (0,   "grain",    "Events per Task",           option::required_arguments);
+  option progress_opt(0,   "progress",
+    "Progress Report Interval in Seconds, 0 Disables Periodic Reports (default: 10)",
+    option::required_arguments);
+  option json_opt    (0,   "progress_json",
+    "Write Progress Reports as JSON Lines to File",
+    option::required_arguments);
+  option seed_opt    (0,   "seed",     "Random Seed",               option::required_arguments);
+  option bench_opt   (0,   "benchmark",
+    "Write Timing, Memory and Output Size Report as JSON to File",
+    option::required_arguments);
+  option cache_opt   (0,   "geometry-cache",
+    "Load Geometry from GDML Cache, Rebuilding and Rewriting it when Stale",
+    option::required_arguments);
+  option truth_opt   (0,   "truth",
+    "Generator Truth Level: none, primaries, hits or full (default: primaries, full with save_all)",
+    option::required_arguments);
 
   //TODO: pass quiet argument to builder and action initiaization to improve quietness
 
   const auto script_argc = -1 + util::cli::parse(argv,
-    {&help_opt, &gen_opt, &det_opt, &shift_opt, &data_opt, &export_opt, &script_opt, &events_opt,
-     &save_all_opt, &vis_opt, &quiet_opt, &thread_opt});
+    {&help_opt, &gen_opt, &det_opt, &physics_opt, &shift_opt, &data_opt, &export_opt, &script_opt,
+     &events_opt, &save_all_opt, &vis_opt, &quiet_opt, &thread_opt, &pin_opt, &task_opt,
+     &grain_opt, &progress_opt, &json_opt, &seed_opt, &bench_opt, &cache_opt, &truth_opt});
 
   util::error::exit_when(script_argc && !script_opt.argument,
     "[FATAL ERROR] Illegal Forwarding Arguments:\n"
@@ -74,12 +141,23 @@ int main(int argc, char* argv[]) {
     "              A script OR an event count can be provided, but not both.\n");
 
   G4Random::setTheEngine(new CLHEP::RanecuEngine);
-  G4Random::setTheSeed(time(nullptr));
+  long seed = time(nullptr);
+  if (seed_opt.argument) {
+    try {
+      seed = std::stol(seed_opt.argument);
+    } catch (...) {
+      std::cout << "[WARNING] Invalid Seed \"" << seed_opt.argument << "\". Using Current Time.\n";
+    }
+  }
+  G4Random::setTheSeed(seed);
+  Physics::Generator::SetSeed(seed);
 
   if (thread_opt.argument) {
     auto opt = std::string(thread_opt.argument);
     if (opt == "on") {
       thread_opt.count = 2;
+    } else if (opt == "auto") {
+      thread_opt.count = util::thread::available_cores();
     } else if (opt == "off" || opt == "0") {
       thread_opt.count = 1;
     } else {
@@ -92,12 +170,64 @@ int main(int argc, char* argv[]) {
   } else if (!thread_opt.count) {
     thread_opt.count = 2;
   }
-  auto run = new G4MTRunManager;
+
+  const auto allowed_cpus = util::thread::allowed_cpus();
+  const auto numa_nodes = util::thread::numa_nodes();
+  const auto cgroup_limit = util::thread::cgroup_cpu_limit();
+  std::cout << "CPU Topology: " << allowed_cpus.size() << " Allowed CPUs ("
+            << util::thread::format_cpu_list(allowed_cpus) << "), "
+            << numa_nodes.size() << (numa_nodes.size() == 1 ? " NUMA Node" : " NUMA Nodes");
+  if (cgroup_limit)
+    std::cout << ", cgroup Limit " << cgroup_limit;
+  std::cout << "\n";
+  for (std::size_t i{}; i < numa_nodes.size(); ++i)
+    std::cout << "  Node " << i << ": " << util::thread::format_cpu_list(numa_nodes[i]) << "\n";
+
+  G4MTRunManager* run;
+#ifdef MU__USE_G4TASKING
+  if (task_opt.count) {
+    run = new G4TaskRunManager;
+  } else {
+    run = new G4MTRunManager;
+  }
+#else
+  if (task_opt.count)
+    std::cout << "[WARNING] Geant4 was built without tasking. Using G4MTRunManager.\n";
+  run = new G4MTRunManager;
+#endif
   run->SetNumberOfThreads(thread_opt.count);
   std::cout << "Running " << thread_opt.count
             << (thread_opt.count > 1 ? " Threads" : " Thread") << "\n";
 
-  run->SetPrintProgress(1000);
+  if (pin_opt.count) {
+    const auto mode = std::string(pin_opt.argument ? pin_opt.argument : "core");
+    if (mode == "core" || mode == "numa") {
+      run->SetUserInitialization(new WorkerInitialization(mode));
+    } else {
+      std::cout << "[WARNING] Unknown Pinning Mode \"" << mode << "\". Threads are not Pinned.\n";
+    }
+  }
+
+  if (grain_opt.argument) {
+    try {
+      run->SetEventModulo(std::stoi(grain_opt.argument));
+    } catch (...) {
+      std::cout << "[WARNING] Invalid Grain Size \"" << grain_opt.argument << "\". Using Default.\n";
+    }
+  }
+
+  auto progress_interval = 10.0;
+  if (progress_opt.argument) {
+    try {
+      progress_interval = std::stod(progress_opt.argument);
+    } catch (...) {
+      std::cout << "[WARNING] Invalid Progress Interval \""
+                << progress_opt.argument << "\". Using Default.\n";
+    }
+  }
+  EventAction::SetProgress(thread_opt.count, progress_interval,
+                           json_opt.argument ? json_opt.argument : "");
+
   run->SetRandomNumberStore(false);
 
   Units::Define();
@@ -105,13 +235,16 @@ int main(int argc, char* argv[]) {
   if (shift_opt.argument)
     Earth::LastShift(std::stold(shift_opt.argument) * m);
 
-  auto physics = new Shielding;
-  physics->RegisterPhysics(new G4StepLimiterPhysics);
-  run->SetUserInitialization(physics);
+  new Physics::Builder(physics_opt.argument ? physics_opt.argument : "Shielding");
 
   const auto detector = det_opt.argument ? det_opt.argument : "Prototype";
   const auto export_dir = export_opt.argument ? export_opt.argument : "";
-  run->SetUserInitialization(new Construction::Builder(detector, export_dir, save_all_opt.count));
+  const auto geometry_cache = cache_opt.argument ? cache_opt.argument : "";
+  run->SetUserInitialization(new Construction::Builder(detector, export_dir, save_all_opt.count, geometry_cache));
+
+  const auto truth = truth_opt.argument ? truth_opt.argument : (save_all_opt.count ? "full" : "primaries");
+  if (!Tracking::SetTruthLevel(truth))
+    std::cout << "[WARNING] Unknown Truth Level \"" << truth << "\". Using Primaries.\n";
 
   const auto generator = gen_opt.argument ? gen_opt.argument : "basic";
   const auto data_dir = data_opt.argument ? data_opt.argument : "data";
@@ -133,6 +266,9 @@ int main(int argc, char* argv[]) {
       Command::Execute("/control/execute scripts/settings/init_gui");
   }
 
+  const auto startup_time
+    = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
   if (script_opt.argument) {
     util::error::exit_when(script_argc % 2,
       "[FATAL ERROR] Illegal Number of Script Forwarding Arguments:\n",
@@ -156,6 +292,10 @@ int main(int argc, char* argv[]) {
     delete ui;
   }
 
+  RunAction::WaitForFinalization();
+  if (bench_opt.argument)
+    _write_benchmark(bench_opt.argument, startup_time);
+
   delete vis;
   delete run;
   return 0;
@@ -17,12 +17,20 @@
 
 #include "tracking.hh"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <iomanip>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <G4SDManager.hh>
 #include <G4RunManager.hh>
+#include <G4Threading.hh>
 #include <tls.hh>
 
+#include "action.hh"
 #include "physics/Units.hh"
 #include "ui.hh"
 
@@ -41,15 +49,24 @@ Hit::Hit(const G4ParticleDefinition* particle,
          const std::string& chamber,
          const double deposit,
          const G4LorentzVector position,
-         const G4LorentzVector momentum)
+         const G4LorentzVector momentum,
+         const int detector)
     : G4VHit(), _particle(particle), _trackID(track), _parentID(parent),
-      _chamberID(chamber), _deposit(deposit), _position(position),
+      _chamberID(chamber), _detectorID(detector), _deposit(deposit), _position(position),
       _momentum(momentum) {}
 //----------------------------------------------------------------------------------------------
 
 //__Hit Constructor_____________________________________________________________________________
 Hit::Hit(const G4Step* step,
-         bool post) {
+         bool post)
+    : Hit(step, step ? step->GetTrack()->GetTouchable()->GetHistory()->GetTopVolume()->GetName()
+                     : "", post) {}
+//----------------------------------------------------------------------------------------------
+
+//__Hit Constructor_____________________________________________________________________________
+Hit::Hit(const G4Step* step,
+         const std::string& chamber,
+         bool post) : _detectorID(-1) {
   if (!step) return;
 
   const auto track = step->GetTrack();
@@ -59,7 +76,7 @@ Hit::Hit(const G4Step* step,
   _particle  = track->GetParticleDefinition();
   _trackID   = track->GetTrackID();
   _parentID  = track->GetParentID();
-  _chamberID = track->GetTouchable()->GetHistory()->GetTopVolume()->GetName();
+  _chamberID = chamber;
   _deposit   = step->GetTotalEnergyDeposit()                / Units::Energy;
   _position  = G4LorentzVector(step_point->GetGlobalTime()  / Units::Time,
                                step_point->GetPosition()    / Units::Length);
@@ -185,7 +202,7 @@ const Analysis::ROOT::DataEntryList _convert_to_analysis(const HitCollection* co
     const auto hit = dynamic_cast<Hit*>(collection->GetHit(i));
     out[0].push_back(hit->GetDeposit());
     out[1].push_back(hit->GetPosition().t());
-    out[2].push_back(name_map(hit->GetChamberID()));
+    out[2].push_back(name_map(*hit));
     out[3].push_back(hit->GetPDGEncoding());
     out[4].push_back(hit->GetTrackID());
     out[5].push_back(hit->GetParentID());
@@ -207,7 +224,9 @@ const Analysis::ROOT::DataEntryList _convert_to_analysis(const HitCollection* co
 
 //__Convert HitCollection to Analysis Form______________________________________________________
 const Analysis::ROOT::DataEntryList ConvertToAnalysis(const HitCollection* collection) {
-  return _convert_to_analysis(collection, [](const auto& id) { return std::stold(id); });
+  return _convert_to_analysis(collection, [](const Hit& hit) {
+    return hit.GetDetectorID() >= 0 ? hit.GetDetectorID() : std::stold(hit.GetChamberID());
+  });
 }
 //----------------------------------------------------------------------------------------------
 
@@ -215,8 +234,8 @@ const Analysis::ROOT::DataEntryList ConvertToAnalysis(const HitCollection* colle
 const Analysis::ROOT::DataEntryList ConvertToAnalysis(const HitCollection* collection,
                                                       const Analysis::ROOT::NameToDataMap& map) {
   const auto map_end = map.cend();
-  return _convert_to_analysis(collection, [&](const auto& id) {
-    const auto search = map.find(id);
+  return _convert_to_analysis(collection, [&](const Hit& hit) {
+    const auto search = map.find(hit.GetChamberID());
     return search != map_end ? search->second : -1;
   });
 }
@@ -306,7 +325,7 @@ const Analysis::ROOT::DataEntryList ConvertToAnalysis(const Physics::ParticleVec
 
 //__Convert Extra to Analysis Form______________________________________________________________
 const Analysis::ROOT::DataEntryList ConvertToAnalysis(const std::vector<std::vector<double>>& extra) {
-  constexpr const std::size_t column_count = 16UL;
+  const auto column_count = EmptyExtra().size();
   Analysis::ROOT::DataEntryList out;
   out.reserve(column_count);
 
@@ -326,6 +345,492 @@ const Analysis::ROOT::DataEntryList ConvertToAnalysis(const std::vector<std::vec
 }
 //----------------------------------------------------------------------------------------------
 
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Current Truth Level_________________________________________________________________________
+// Set from the master thread between runs and only read by the workers during a run.
+TruthLevel _truth_level = TruthLevel::Primaries;
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Truth Level Names___________________________________________________________________________
+const std::string& TruthLevelNames() {
+  static const std::string _names = "none primaries hits full";
+  return _names;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Truth Level from Name___________________________________________________________________
+bool SetTruthLevel(const std::string& level) {
+  if (level == "none")
+    _truth_level = TruthLevel::None;
+  else if (level == "primaries")
+    _truth_level = TruthLevel::Primaries;
+  else if (level == "hits")
+    _truth_level = TruthLevel::Hits;
+  else if (level == "full")
+    _truth_level = TruthLevel::Full;
+  else
+    return false;
+  return true;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Truth Level_____________________________________________________________________________
+void SetTruthLevel(const TruthLevel level) {
+  _truth_level = level;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Truth Level_____________________________________________________________________________
+TruthLevel GetTruthLevel() {
+  return _truth_level;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Get Truth Level Name________________________________________________________________________
+const std::string GetTruthLevelName() {
+  switch (_truth_level) {
+    case TruthLevel::None:      return "none";
+    case TruthLevel::Primaries: return "primaries";
+    case TruthLevel::Hits:      return "hits";
+    case TruthLevel::Full:      return "full";
+  }
+  return "";
+}
+//----------------------------------------------------------------------------------------------
+
+//__Convert Generator Truth to Analysis Form at Current Truth Level_____________________________
+const Analysis::ROOT::DataEntryList ConvertTruthToAnalysis(const HitCollection* collection) {
+  switch (_truth_level) {
+    case TruthLevel::None:
+      return ConvertToAnalysis(Physics::ParticleVector{});
+    case TruthLevel::Full:
+      return ConvertToAnalysis(GeneratorAction::GetLastEvent());
+    case TruthLevel::Primaries:
+      return ConvertToAnalysis(EventAction::GetEvent());
+    case TruthLevel::Hits:
+      break;
+  }
+
+  std::unordered_set<int> tracks;
+  const auto size = collection ? collection->GetSize() : 0UL;
+  for (std::size_t i{}; i < size; ++i) {
+    const auto hit = dynamic_cast<Hit*>(collection->GetHit(i));
+    tracks.insert(hit->GetTrackID());
+    tracks.insert(hit->GetParentID());
+  }
+
+  const auto primaries = ConvertToAnalysis(EventAction::GetEvent());
+  Analysis::ROOT::DataEntryList out(primaries.size());
+  for (std::size_t i{}; i < primaries[1].size(); ++i) {
+    if (!tracks.count(static_cast<int>(primaries[1][i])))
+      continue;
+    for (std::size_t column{}; column < primaries.size(); ++column)
+      out[column].push_back(primaries[column][i]);
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Event with Generator Truth to NTuple__________________________________________________
+void WriteEvent(const std::string& name,
+                const Analysis::ROOT::DataKeyTypeList& types,
+                const HitCollection* collection,
+                Analysis::ROOT::DataEntryList& hit_data) {
+  const auto gen_particle_data = ConvertTruthToAnalysis(collection);
+  const auto extra_gen_data = ConvertToAnalysis(GeneratorAction::GetGenerator()->ExtraDetails());
+  hit_data.reserve(hit_data.size() + gen_particle_data.size() + extra_gen_data.size());
+  hit_data.insert(hit_data.cend(), gen_particle_data.cbegin(), gen_particle_data.cend());
+  hit_data.insert(hit_data.cend(), extra_gen_data.cbegin(), extra_gen_data.cend());
+
+  Analysis::ROOT::DataEntry metadata;
+  metadata.reserve(2UL);
+  metadata.push_back(collection ? collection->GetSize() : 0UL);
+  metadata.push_back(gen_particle_data[0UL].size());
+
+  Analysis::ROOT::FillNTuple(name, types, metadata, hit_data);
+}
+//----------------------------------------------------------------------------------------------
+
+namespace Trigger { ////////////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Trigger Settings____________________________________________________________________________
+// Set from the master thread between runs and only read by the workers during a run.
+bool _enabled = false;
+std::size_t _required = 1UL;
+double _window = 0;
+double _threshold = 0;
+std::vector<std::pair<long, long>> _layers;
+std::vector<std::uint64_t> _masks;
+//----------------------------------------------------------------------------------------------
+
+//__Trigger Counters____________________________________________________________________________
+std::atomic<std::size_t> _accepted{0};
+std::atomic<std::size_t> _rejected{0};
+//----------------------------------------------------------------------------------------------
+
+//__Fired Element_______________________________________________________________________________
+struct Fired {
+  double time;
+  long layer;
+};
+//----------------------------------------------------------------------------------------------
+
+//__Get Layer Index of Detector ID (-1 if in No Layer)__________________________________________
+long _layer_of(const long id) {
+  if (_layers.empty())
+    return id;
+  for (std::size_t i{}; i < _layers.size(); ++i)
+    if (_layers[i].first <= id && id <= _layers[i].second)
+      return static_cast<long>(i);
+  return -1L;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Layers Fired in Window Pass Trigger Logic__________________________________________
+bool _passes(const std::vector<Fired>& fired,
+             const std::size_t begin,
+             const std::size_t end) {
+  if (_layers.empty()) {
+    std::vector<long> layers;
+    layers.reserve(end - begin);
+    for (auto i = begin; i < end; ++i)
+      layers.push_back(fired[i].layer);
+    std::sort(layers.begin(), layers.end());
+    return static_cast<std::size_t>(std::unique(layers.begin(), layers.end()) - layers.begin()) >= _required;
+  }
+
+  std::uint64_t pattern{};
+  for (auto i = begin; i < end; ++i)
+    pattern |= std::uint64_t{1} << fired[i].layer;
+
+  std::size_t count{};
+  for (auto bits = pattern; bits; bits &= bits - 1)
+    ++count;
+  if (count < _required)
+    return false;
+
+  if (_masks.empty())
+    return true;
+  return std::any_of(_masks.cbegin(), _masks.cend(),
+    [&](const std::uint64_t mask) { return (pattern & mask) == mask; });
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Enable Trigger______________________________________________________________________________
+void Enable(const bool enable) {
+  _enabled = enable;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Trigger is Enabled_________________________________________________________________
+bool IsEnabled() {
+  return _enabled;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Add Trigger Layer___________________________________________________________________________
+void AddLayer(const long first,
+              const long last) {
+  if (_layers.size() == 64UL) {
+    std::cout << "[WARNING] Trigger Supports at most 64 Layers.\n";
+    return;
+  }
+  _layers.emplace_back(std::min(first, last), std::max(first, last));
+}
+//----------------------------------------------------------------------------------------------
+
+//__Add Trigger Mask____________________________________________________________________________
+void AddMask(const std::vector<std::size_t>& layers) {
+  std::uint64_t mask{};
+  for (const auto layer : layers) {
+    if (layer >= _layers.size()) {
+      std::cout << "[WARNING] Trigger Mask uses Undefined Layer " << layer << ".\n";
+      return;
+    }
+    mask |= std::uint64_t{1} << layer;
+  }
+  if (mask)
+    _masks.push_back(mask);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Clear Trigger Layers and Masks______________________________________________________________
+void Clear() {
+  _layers.clear();
+  _masks.clear();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Required Number of Layers_______________________________________________________________
+void SetRequired(const std::size_t layers) {
+  _required = layers;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Coincidence Window (0 for None)_________________________________________________________
+void SetWindow(const double window) {
+  _window = window;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Set Element Deposit Threshold_______________________________________________________________
+void SetThreshold(const double threshold) {
+  _threshold = threshold;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Evaluate Trigger on Hit Collection__________________________________________________________
+bool Accept(const HitCollection* collection) {
+  if (!_enabled)
+    return true;
+
+  std::unordered_map<long, std::pair<double, double>> elements;
+  const auto size = collection ? collection->GetSize() : 0UL;
+  for (std::size_t i{}; i < size; ++i) {
+    const auto hit = dynamic_cast<Hit*>(collection->GetHit(i));
+    const auto id = hit->GetDetectorID() >= 0 ? hit->GetDetectorID() : std::stol(hit->GetChamberID());
+    const auto time = hit->GetPosition().t() * Units::Time;
+    const auto search = elements.find(id);
+    if (search == elements.end()) {
+      elements.emplace(id, std::make_pair(hit->GetDeposit() * Units::Energy, time));
+    } else {
+      search->second.first += hit->GetDeposit() * Units::Energy;
+      search->second.second = std::min(search->second.second, time);
+    }
+  }
+
+  std::vector<Fired> fired;
+  fired.reserve(elements.size());
+  for (const auto& element : elements) {
+    if (element.second.first < _threshold)
+      continue;
+    const auto layer = _layer_of(element.first);
+    if (layer >= 0)
+      fired.push_back({element.second.second, layer});
+  }
+  std::sort(fired.begin(), fired.end(),
+    [](const Fired& left, const Fired& right) { return left.time < right.time; });
+
+  auto accept = false;
+  if (fired.size() >= _required) {
+    if (_window <= 0) {
+      accept = _passes(fired, 0UL, fired.size());
+    } else {
+      std::size_t end{};
+      for (std::size_t begin{}; begin < fired.size() && !accept; ++begin) {
+        end = std::max(end, begin);
+        while (end < fired.size() && fired[end].time - fired[begin].time <= _window)
+          ++end;
+        accept = end - begin >= _required && _passes(fired, begin, end);
+      }
+    }
+  }
+
+  ++(accept ? _accepted : _rejected);
+  return accept;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Print Trigger Settings______________________________________________________________________
+void Print(std::ostream& os) {
+  os << "Trigger: " << (_enabled ? "on" : "off")
+     << ", " << _required << (_layers.empty() ? " elements" : " layers")
+     << " above " << G4BestUnit(_threshold, "Energy");
+  if (_window > 0)
+    os << " within " << G4BestUnit(_window, "Time");
+  os << "\n";
+  for (std::size_t i{}; i < _layers.size(); ++i)
+    os << "  Layer " << i << ": " << _layers[i].first << " to " << _layers[i].second << "\n";
+  for (const auto mask : _masks) {
+    os << "  Mask:";
+    for (std::size_t i{}; i < 64UL; ++i)
+      if (mask & (std::uint64_t{1} << i))
+        os << " " << i;
+    os << "\n";
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Print and Reset Trigger Counts______________________________________________________________
+void PrintCounts(std::ostream& os) {
+  const auto accepted = _accepted.exchange(0);
+  const auto rejected = _rejected.exchange(0);
+  if (!_enabled && !accepted && !rejected)
+    return;
+  os << "Triggered Events: " << accepted << " / " << (accepted + rejected)
+     << " (" << rejected << " discarded)\n";
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Trigger */ //////////////////////////////////////////////////////////////////////
+
+namespace Memory { /////////////////////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Memory Instrumentation Settings_____________________________________________________________
+G4ThreadLocal bool _enabled = false;
+//----------------------------------------------------------------------------------------------
+
+//__Thread Local Usage for Current Run__________________________________________________________
+G4ThreadLocal Usage _usage{};
+//----------------------------------------------------------------------------------------------
+
+//__Published Worker Usage______________________________________________________________________
+// each worker writes only its own slot at the end of the run, and the master reads the slots
+// after all workers have finished, so no lock is needed
+UsageList _published;
+//----------------------------------------------------------------------------------------------
+
+//__String Capacity Held Inline_________________________________________________________________
+std::size_t _inline_capacity() {
+  static const auto capacity = std::string().capacity();
+  return capacity;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Format Bytes as Kilobytes___________________________________________________________________
+std::string _kilobytes(const std::size_t bytes) {
+  std::ostringstream stream;
+  stream << std::fixed << std::setprecision(1) << bytes / 1024.0 << " kB";
+  return stream.str();
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Enable Memory Instrumentation on this Thread________________________________________________
+void Enable(const bool enable) {
+  _enabled = enable;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Check if Memory Instrumentation is Enabled on this Thread___________________________________
+bool IsEnabled() {
+  return _enabled;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Record Hit Memory of Event__________________________________________________________________
+void RecordEvent(const HitCollection* collection) {
+  ++_usage.events;
+  if (!collection)
+    return;
+
+  const auto size = collection->GetSize();
+  std::size_t bytes = collection->GetVector()->capacity() * sizeof(Hit*);
+  std::size_t allocations = size;
+  for (std::size_t i{}; i < size; ++i) {
+    bytes += sizeof(Hit);
+    const auto capacity = (*collection)[i]->GetChamberID().capacity();
+    if (capacity > _inline_capacity()) {
+      bytes += capacity + 1UL;
+      ++allocations;
+    }
+  }
+
+  _usage.hits += size;
+  _usage.allocations += allocations;
+  _usage.peak_hits = std::max(_usage.peak_hits, size);
+  _usage.peak_hit_bytes = std::max(_usage.peak_hit_bytes, bytes);
+  _usage.peak_allocations = std::max(_usage.peak_allocations, allocations);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Reset Published Usage for New Run___________________________________________________________
+void Prepare(const std::size_t threads) {
+  _published.clear();
+  _published.resize(threads, Usage{});
+}
+//----------------------------------------------------------------------------------------------
+
+//__Publish Thread Usage at End of Run__________________________________________________________
+void Publish() {
+  if (!_enabled)
+    return;
+
+  if (HitAllocator) {
+    _usage.allocator_pages = static_cast<std::size_t>(HitAllocator->GetNoPages());
+    _usage.allocator_bytes = HitAllocator->GetAllocatedSize();
+  }
+  _usage.ntuple_bytes = Analysis::ROOT::DataCapacity();
+
+  const auto id = G4Threading::G4GetThreadId();
+  _usage.thread = id;
+  if (id >= 0 && static_cast<std::size_t>(id) < _published.size())
+    _published[id] = _usage;
+  _usage = Usage{};
+}
+//----------------------------------------------------------------------------------------------
+
+//__Merge Published Usage_______________________________________________________________________
+UsageList Merge() {
+  UsageList out;
+  for (const auto& usage : _published)
+    if (usage.events)
+      out.push_back(usage);
+  _published.clear();
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Memory Usage Run Metadata___________________________________________________________________
+Analysis::SimSettingList Specification(const UsageList& usage) {
+  if (usage.empty())
+    return {};
+
+  Usage total{};
+  for (const auto& entry : usage) {
+    total.events += entry.events;
+    total.hits += entry.hits;
+    total.allocations += entry.allocations;
+    total.peak_hits = std::max(total.peak_hits, entry.peak_hits);
+    total.peak_hit_bytes = std::max(total.peak_hit_bytes, entry.peak_hit_bytes);
+    total.peak_allocations = std::max(total.peak_allocations, entry.peak_allocations);
+    total.allocator_pages += entry.allocator_pages;
+    total.allocator_bytes += entry.allocator_bytes;
+    total.ntuple_bytes += entry.ntuple_bytes;
+  }
+
+  return Analysis::Settings("MEMORY_",
+    "PEAK_HITS",        std::to_string(total.peak_hits),
+    "PEAK_HIT_BYTES",   std::to_string(total.peak_hit_bytes),
+    "HITS",             std::to_string(total.hits),
+    "ALLOCATIONS",      std::to_string(total.allocations),
+    "PEAK_ALLOCATIONS", std::to_string(total.peak_allocations),
+    "ALLOCATOR_PAGES",  std::to_string(total.allocator_pages),
+    "ALLOCATOR_BYTES",  std::to_string(total.allocator_bytes),
+    "NTUPLE_BYTES",     std::to_string(total.ntuple_bytes));
+}
+//----------------------------------------------------------------------------------------------
+
+//__Print Memory Usage by Thread________________________________________________________________
+void Print(const UsageList& usage,
+           std::ostream& os) {
+  if (usage.empty())
+    return;
+
+  os << "Hit Memory:\n";
+  for (const auto& entry : usage) {
+    os << "  Thread " << entry.thread << ": "
+       << entry.events << " events, " << entry.hits << " hits, peak "
+       << entry.peak_hits << " hits (" << _kilobytes(entry.peak_hit_bytes) << ") per event, "
+       << entry.allocations << " allocations (peak " << entry.peak_allocations << " per event), "
+       << "allocator " << entry.allocator_pages << " pages (" << _kilobytes(entry.allocator_bytes) << "), "
+       << "ntuple columns " << _kilobytes(entry.ntuple_bytes) << "\n";
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+} /* namespace Memory */ ///////////////////////////////////////////////////////////////////////
+
 } /* namespace Tracking */ /////////////////////////////////////////////////////////////////////
 
 } } /* namespace MATHUSLA::MU */
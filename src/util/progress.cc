@@ -0,0 +1,157 @@
+/*
+ * src/util/progress.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "util/progress.hh"
+
+#include <iomanip>
+#include <sstream>
+
+namespace MATHUSLA {
+
+namespace util { namespace progress { //////////////////////////////////////////////////////////
+
+//__Reporter Constructor________________________________________________________________________
+reporter::reporter(std::size_t slots,
+                   double interval,
+                   bool json,
+                   std::ostream& os)
+    : _slot_count(slots),
+      _slots(new slot[slots]),
+      _interval(interval),
+      _json(json),
+      _os(os),
+      _total(0),
+      _last_events(slots, 0),
+      _running(false) {
+  for (std::size_t i{}; i < _slot_count; ++i) {
+    _slots[i].events.store(0, std::memory_order_relaxed);
+    _slots[i].hits.store(0, std::memory_order_relaxed);
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Reporter Destructor_________________________________________________________________________
+reporter::~reporter() {
+  stop();
+}
+//----------------------------------------------------------------------------------------------
+
+//__Reset Counters and Start Reporter Thread____________________________________________________
+void reporter::start(std::size_t total) {
+  stop();
+  for (std::size_t i{}; i < _slot_count; ++i) {
+    _slots[i].events.store(0, std::memory_order_relaxed);
+    _slots[i].hits.store(0, std::memory_order_relaxed);
+    _last_events[i] = 0;
+  }
+  _total = total;
+  _start = _last = clock::now();
+  _running = true;
+  if (_interval > 0)
+    _thread = std::thread(&reporter::_run, this);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Stop Reporter Thread and Write Final Report_________________________________________________
+void reporter::stop() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_running)
+      return;
+    _running = false;
+  }
+  _wake.notify_all();
+  if (_thread.joinable())
+    _thread.join();
+  _report(true);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Reporter Thread Loop________________________________________________________________________
+void reporter::_run() {
+  const auto interval = std::chrono::duration<double>(_interval);
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (!_wake.wait_for(lock, interval, [&]{ return !_running; })) {
+    lock.unlock();
+    _report(false);
+    lock.lock();
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Write Progress Report_______________________________________________________________________
+void reporter::_report(bool final) {
+  const auto now = clock::now();
+  const auto elapsed = std::chrono::duration<double>(now - _start).count();
+  const auto window = std::chrono::duration<double>(now - _last).count();
+  _last = now;
+
+  std::uint_fast64_t events{}, hits{};
+  std::vector<double> rates(_slot_count, 0);
+  for (std::size_t i{}; i < _slot_count; ++i) {
+    const auto slot_events = _slots[i].events.load(std::memory_order_relaxed);
+    events += slot_events;
+    hits += _slots[i].hits.load(std::memory_order_relaxed);
+    if (window > 0)
+      rates[i] = (slot_events - _last_events[i]) / window;
+    _last_events[i] = slot_events;
+  }
+
+  const auto rate = elapsed > 0 ? events / elapsed : 0.0;
+  const auto eta = !final && rate > 0 && _total > events ? (_total - events) / rate : 0.0;
+  const auto hits_per_event = events ? static_cast<double>(hits) / events : 0.0;
+
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2);
+  if (_json) {
+    out << "{\"final\":" << (final ? "true" : "false")
+        << ",\"elapsed\":" << elapsed
+        << ",\"events\":" << events
+        << ",\"total\":" << _total
+        << ",\"rate\":" << rate
+        << ",\"eta\":" << eta
+        << ",\"hits_per_event\":" << hits_per_event
+        << ",\"thread_rates\":[";
+    for (std::size_t i{}; i < _slot_count; ++i)
+      out << (i ? "," : "") << rates[i];
+    out << "]}\n";
+  } else {
+    out << (final ? "Completed " : "Progress: ") << events << " / " << _total << " Events";
+    if (_total)
+      out << " (" << 100.0 * events / _total << "%)";
+    out << " | " << rate << " Events/s | ";
+    if (final) {
+      out << "Elapsed " << elapsed << " s";
+    } else {
+      out << "ETA " << eta << " s";
+    }
+    out << " | " << hits_per_event << " Hits/Event";
+    if (!final) {
+      out << " | Thread Events/s:";
+      for (const auto thread_rate : rates)
+        out << ' ' << thread_rate;
+    }
+    out << '\n';
+  }
+  _os << out.str() << std::flush;
+}
+//----------------------------------------------------------------------------------------------
+
+} } /* namespace util::progress */ /////////////////////////////////////////////////////////////
+
+} /* namespace MATHUSLA */
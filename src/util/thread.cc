@@ -0,0 +1,177 @@
+/*
+ * src/util/thread.cc
+ *
+ * Copyright 2018 Brandon Gomes
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "util/thread.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "util/io.hh"
+
+namespace MATHUSLA {
+
+namespace util { namespace thread { ////////////////////////////////////////////////////////////
+
+namespace { ////////////////////////////////////////////////////////////////////////////////////
+
+//__Read First Line of File_____________________________________________________________________
+std::string _read_line(const std::string& path) {
+  std::ifstream file(path);
+  std::string line;
+  std::getline(file, line);
+  return line;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Quota over Period Rounded Up________________________________________________________________
+std::size_t _quota_limit(long long quota,
+                         long long period) {
+  if (quota <= 0 || period <= 0)
+    return 0;
+  return static_cast<std::size_t>(std::ceil(static_cast<double>(quota) / period));
+}
+//----------------------------------------------------------------------------------------------
+
+} /* anonymous namespace */ ////////////////////////////////////////////////////////////////////
+
+//__Parse Kernel CPU List_______________________________________________________________________
+cpu_list parse_cpu_list(const std::string& text) {
+  cpu_list out;
+  std::istringstream stream(text);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    try {
+      const auto dash = range.find('-');
+      const auto first = std::stoi(range.substr(0, dash));
+      const auto last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+      for (auto cpu = first; cpu <= last; ++cpu)
+        out.push_back(cpu);
+    } catch (...) {}
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Format CPU List in Kernel Notation__________________________________________________________
+std::string format_cpu_list(const cpu_list& cpus) {
+  std::string out;
+  for (std::size_t i{}; i < cpus.size();) {
+    auto j = i;
+    while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1)
+      ++j;
+    if (!out.empty())
+      out += ',';
+    out += std::to_string(cpus[i]);
+    if (j > i)
+      out += '-' + std::to_string(cpus[j]);
+    i = j + 1;
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__CPUs this Process is Allowed to Run On______________________________________________________
+cpu_list allowed_cpus() {
+  cpu_list out;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (!sched_getaffinity(0, sizeof(set), &set)) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+      if (CPU_ISSET(cpu, &set))
+        out.push_back(cpu);
+  }
+#endif
+  if (out.empty()) {
+    const auto count = std::max(1U, std::thread::hardware_concurrency());
+    for (unsigned int cpu = 0; cpu < count; ++cpu)
+      out.push_back(static_cast<int>(cpu));
+  }
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__CPU Limit from cgroup Quota_________________________________________________________________
+std::size_t cgroup_cpu_limit() {
+  // cgroup v2 stores "<quota> <period>" with "max" for no quota
+  try {
+    std::istringstream v2(_read_line("/sys/fs/cgroup/cpu.max"));
+    std::string quota;
+    long long period{};
+    if (v2 >> quota >> period)
+      return quota == "max" ? 0 : _quota_limit(std::stoll(quota), period);
+
+    return _quota_limit(std::stoll(_read_line("/sys/fs/cgroup/cpu/cpu.cfs_quota_us")),
+                        std::stoll(_read_line("/sys/fs/cgroup/cpu/cpu.cfs_period_us")));
+  } catch (...) {
+    return 0;
+  }
+}
+//----------------------------------------------------------------------------------------------
+
+//__Usable Number of Cores______________________________________________________________________
+std::size_t available_cores() {
+  const auto cores = allowed_cpus().size();
+  const auto limit = cgroup_cpu_limit();
+  return std::max<std::size_t>(1, limit ? std::min(cores, limit) : cores);
+}
+//----------------------------------------------------------------------------------------------
+
+//__Allowed CPUs Grouped by NUMA Node___________________________________________________________
+std::vector<cpu_list> numa_nodes() {
+  const auto allowed = allowed_cpus();
+  std::vector<cpu_list> out;
+  for (int node = 0; util::io::path_exists("/sys/devices/system/node/node" + std::to_string(node)); ++node) {
+    cpu_list cpus;
+    for (const auto cpu : parse_cpu_list(_read_line("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist")))
+      if (std::find(allowed.cbegin(), allowed.cend(), cpu) != allowed.cend())
+        cpus.push_back(cpu);
+    if (!cpus.empty())
+      out.push_back(cpus);
+  }
+  if (out.empty())
+    out.push_back(allowed);
+  return out;
+}
+//----------------------------------------------------------------------------------------------
+
+//__Bind Calling Thread to CPUs_________________________________________________________________
+bool pin_current_thread(const cpu_list& cpus) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (const auto cpu : cpus)
+    CPU_SET(cpu, &set);
+  return !cpus.empty() && !pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  return false;
+#endif
+}
+//----------------------------------------------------------------------------------------------
+
+} } /* namespace util::thread */ ///////////////////////////////////////////////////////////////
+
+} /* namespace MATHUSLA */
@@ -0,0 +1,9 @@
+#!/bin/bash
+# Muon Survival Table
+
+DATA_TO="../muon_map/table_$1"
+for ENERGY in 10 20 50 100 200 500 1000; do
+  mkdir -p $DATA_TO/$ENERGY
+  ./simulation -j$2 -q -o $DATA_TO/$ENERGY -s studies/muon_map/loop.mac energy $ENERGY count 1000
+done
+root -l -b -q "studies/muon_map/survival_table.C(\"$DATA_TO:${3:-100}\", \"$DATA_TO/survival.bin\")"
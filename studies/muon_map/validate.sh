@@ -0,0 +1,8 @@
+#!/bin/bash
+# Fast Muon Transport Validation
+
+DATA_TO="../muon_map/validate_$1"
+mkdir -p $DATA_TO/full $DATA_TO/fast
+./simulation -j$2 -q -o $DATA_TO/full -s studies/muon_map/validate.mac fast false energy 100 count 1000
+./simulation -j$2 -q -o $DATA_TO/fast -s studies/muon_map/validate.mac fast true energy 100 count 1000
+root -l -b -q "studies/muon_map/validate.C(\"$DATA_TO/full\", \"$DATA_TO/fast\", \"$DATA_TO/validate.root\")"